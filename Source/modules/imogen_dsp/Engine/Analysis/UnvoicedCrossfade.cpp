@@ -0,0 +1,65 @@
+namespace Imogen
+{
+template <typename SampleType>
+void UnvoicedCrossfade<SampleType>::reset()
+{
+	mix		= 0;
+	target	= 0;
+	dryGain = targetDryGain;
+}
+
+template <typename SampleType>
+void UnvoicedCrossfade<SampleType>::setTarget (bool passThrough) noexcept
+{
+	target = passThrough ? SampleType (1) : SampleType (0);
+}
+
+template <typename SampleType>
+bool UnvoicedCrossfade<SampleType>::needsSynthesis() const noexcept
+{
+	return mix < SampleType (1) || target < SampleType (1);
+}
+
+template <typename SampleType>
+void UnvoicedCrossfade<SampleType>::process (SampleType* signal, const SampleType* dry, int numSamples) noexcept
+{
+	if (numSamples <= 0)
+		return;
+
+	if (mix == target)
+	{
+		// nothing of the dry signal is heard, so its level can jump
+		if (mix == SampleType (0))
+		{
+			dryGain = targetDryGain;
+			return;
+		}
+
+		if (dryGain == targetDryGain)
+		{
+			juce::FloatVectorOperations::copyWithMultiply (signal, dry, dryGain, numSamples);
+			return;
+		}
+	}
+
+	const auto step = target > mix ? rampStep : -rampStep;
+
+	// the dry level moves at the same rate as the crossfade, however short the blocks are
+	const auto gainStep = targetDryGain > dryGain ? rampStep : -rampStep;
+
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		if (mix != target)
+			mix = juce::jlimit (SampleType (0), SampleType (1), mix + step);
+
+		if (dryGain != targetDryGain)
+			dryGain = gainStep > 0 ? std::min (targetDryGain, dryGain + gainStep) : std::max (targetDryGain, dryGain + gainStep);
+
+		signal[i] += mix * (dry[i] * dryGain - signal[i]);
+	}
+}
+
+template class UnvoicedCrossfade<float>;
+template class UnvoicedCrossfade<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	Crossfades a resynthesized signal with the dry input it was made from, following a VoicingDetector.
+	Once the fade has reached the dry signal, the resynthesis isn't needed at all until the input is voiced again.
+*/
+template <typename SampleType>
+class UnvoicedCrossfade
+{
+public:
+
+	void reset();
+
+	// call once before each render, with whether the dry input should be heard
+	void setTarget (bool passThrough) noexcept;
+
+	// false while only the dry input is being heard, in which case there's no need to render anything into signal
+	bool needsSynthesis() const noexcept;
+
+	// the level the dry input is mixed in at. A change is ramped at the crossfade's rate, so it takes the same time
+	// whatever the block size
+	void setDryGain (SampleType newGain) noexcept { targetDryGain = newGain; }
+
+	// signal holds the resynthesized samples (if needsSynthesis() returned true), and is replaced with the mix
+	void process (SampleType* signal, const SampleType* dry, int numSamples) noexcept;
+
+private:
+
+	// the length of a full fade, in samples
+	static constexpr auto rampLength = 256;
+
+	static constexpr auto rampStep = SampleType (1) / SampleType (rampLength);
+
+	SampleType mix { 0 }, target { 0 };
+
+	SampleType dryGain { 1 }, targetDryGain { 1 };
+};
+
+}  // namespace Imogen
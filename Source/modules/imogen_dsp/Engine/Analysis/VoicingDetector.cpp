@@ -0,0 +1,79 @@
+namespace Imogen
+{
+template <typename SampleType>
+VoicingDetector<SampleType>::VoicingDetector (Internals& internalsToUse)
+	: internals (internalsToUse)
+{
+}
+
+template <typename SampleType>
+void VoicingDetector<SampleType>::prepare (double newSamplerate)
+{
+	jassert (newSamplerate > 0.);
+
+	samplerate = newSamplerate;
+	reset();
+}
+
+template <typename SampleType>
+void VoicingDetector<SampleType>::reset()
+{
+	lastSample = 0;
+	confidence = 1.f;
+	voiced	   = true;
+	frame	   = nullptr;
+}
+
+template <typename SampleType>
+void VoicingDetector<SampleType>::analyze (const SampleType* input, int numSamples)
+{
+	jassert (input != nullptr && numSamples > 0);
+
+	frame = input;
+
+	auto signalEnergy = 0., differenceEnergy = 0.;
+
+	auto previous = lastSample;
+
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		const auto sample	  = static_cast<double> (input[i]);
+		const auto difference = sample - static_cast<double> (previous);
+
+		signalEnergy += sample * sample;
+		differenceEnergy += difference * difference;
+
+		previous = input[i];
+	}
+
+	lastSample = previous;
+
+	if (signalEnergy < silenceThreshold * numSamples)
+		return;
+
+	const auto frequency = getRmsFrequency (signalEnergy, differenceEnergy);
+
+	confidence = juce::jlimit (0.f, 1.f, (unvoicedHz - frequency) / (unvoicedHz - voicedHz));
+
+	if (voiced)
+		voiced = confidence > 0.5f - hysteresis;
+	else
+		voiced = confidence > 0.5f + hysteresis;
+
+	if (publishesInternals)
+		internals.voicingConfidence->set (juce::roundToInt (confidence * 100.f));
+}
+
+template <typename SampleType>
+float VoicingDetector<SampleType>::getRmsFrequency (double signalEnergy, double differenceEnergy) const
+{
+	// for a sinusoid at f, the first difference has 4 sin^2 (pi f / fs) times the energy of the signal
+	const auto ratio = std::min (4., differenceEnergy / signalEnergy);
+
+	return static_cast<float> (samplerate / juce::MathConstants<double>::pi * std::asin (std::sqrt (ratio) * 0.5));
+}
+
+template class VoicingDetector<float>;
+template class VoicingDetector<double>;
+
+}  // namespace Imogen
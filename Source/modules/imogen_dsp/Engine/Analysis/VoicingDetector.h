@@ -0,0 +1,74 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	Decides, once per analysis frame, whether the input is voiced.
+
+	The measure is the ratio of the energy of the signal's first difference to the energy of the signal itself, which
+	gives the RMS frequency of the frame's spectrum. Sung vowels sit well below a couple of kHz, while sibilants,
+	breaths and most consonants sit above it. The frame's samples are kept, so that the voices and the lead can pass
+	the input straight through while it's unvoiced.
+*/
+template <typename SampleType>
+class VoicingDetector
+{
+public:
+
+	VoicingDetector (Internals& internalsToUse);
+
+	void prepare (double samplerate);
+
+	void reset();
+
+	// input must stay valid until the lead has rendered this frame
+	void analyze (const SampleType* input, int numSamples);
+
+	// 0 for certainly unvoiced, 1 for certainly voiced
+	float getConfidence() const noexcept { return confidence; }
+
+	bool isVoiced() const noexcept { return voiced; }
+
+	// when false, the voices and the lead always resynthesize
+	void setPassthroughEnabled (bool shouldBeEnabled) noexcept { passthroughEnabled = shouldBeEnabled; }
+
+	// true if the current frame should be passed through rather than resynthesized
+	bool shouldPassThrough() const noexcept { return passthroughEnabled && ! voiced; }
+
+	const SampleType* getFrame() const noexcept { return frame; }
+
+	// when false, the confidence isn't written to Internals
+	void setPublishesInternals (bool shouldPublish) noexcept { publishesInternals = shouldPublish; }
+
+private:
+
+	float getRmsFrequency (double signalEnergy, double differenceEnergy) const;
+
+	// the RMS frequencies at which a frame is treated as fully voiced and fully unvoiced
+	static constexpr auto voicedHz	 = 1500.f;
+	static constexpr auto unvoicedHz = 3000.f;
+
+	// the decision only flips once the confidence has crossed to the far side of 0.5, so a borderline frame doesn't
+	// bounce the voices back and forth
+	static constexpr auto hysteresis = 0.15f;
+
+	// frames quieter than this (about -100 dBFS RMS) keep the previous decision
+	static constexpr auto silenceThreshold = 1.0e-10;
+
+	Internals& internals;
+
+	bool publishesInternals { true };
+
+	double samplerate { 44100. };
+
+	SampleType lastSample { 0 };
+
+	float confidence { 1.f };
+	bool  voiced { true };
+
+	bool passthroughEnabled { true };
+
+	const SampleType* frame { nullptr };
+};
+
+}  // namespace Imogen
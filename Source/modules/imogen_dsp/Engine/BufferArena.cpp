@@ -0,0 +1,110 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void BufferArena<SampleType>::clear()
+{
+	requests.clear();
+}
+
+template <typename SampleType>
+void BufferArena<SampleType>::request (AudioBuffer& buffer, int numChannels, Stage firstUse, Stage lastUse)
+{
+	jassert (numChannels > 0 && firstUse <= lastUse);
+
+	requests.push_back ({ &buffer, numChannels, static_cast<int> (firstUse), static_cast<int> (lastUse), 0 });
+}
+
+template <typename SampleType>
+void BufferArena<SampleType>::allocate (int blocksize)
+{
+	// every channel starts on a cache line
+	const auto channelBytes = (static_cast<size_t> (blocksize) * sizeof (SampleType) + alignment - 1) / alignment * alignment;
+
+	sorted.clear();
+	placed.clear();
+
+	for (auto& r : requests)
+		sorted.push_back (&r);
+
+	// placing the biggest buffers first gives a tighter packing
+	std::stable_sort (sorted.begin(), sorted.end(),
+					  [] (const Request* a, const Request* b)
+					  { return a->numChannels > b->numChannels; });
+
+	totalBytes = 0;
+
+	for (auto* r : sorted)
+	{
+		const auto size = channelBytes * static_cast<size_t> (r->numChannels);
+
+		const auto overlaps = [r] (const Request* other)
+		{ return other->firstUse <= r->lastUse && r->firstUse <= other->lastUse; };
+
+		const auto collides = [&] (size_t offset)
+		{
+			for (const auto* other : placed)
+				if (overlaps (other)
+					&& offset < other->offset + channelBytes * static_cast<size_t> (other->numChannels)
+					&& other->offset < offset + size)
+					return true;
+
+			return false;
+		};
+
+		// first fit: try the start of the arena, then the end of each buffer that's alive at the same time
+		auto offset = size_t (0);
+
+		if (collides (offset))
+		{
+			offset = std::numeric_limits<size_t>::max();
+
+			for (const auto* other : placed)
+			{
+				if (! overlaps (other))
+					continue;
+
+				const auto candidate = other->offset + channelBytes * static_cast<size_t> (other->numChannels);
+
+				if (candidate < offset && ! collides (candidate))
+					offset = candidate;
+			}
+		}
+
+		r->offset = offset;
+		placed.push_back (r);
+
+		totalBytes = std::max (totalBytes, offset + size);
+	}
+
+	if (totalBytes > capacityBytes)
+	{
+		memory.allocate (totalBytes + alignment, true);
+		capacityBytes = totalBytes;
+	}
+	else
+	{
+		// reused memory may still hold the last stream's signal
+		std::memset (memory.get(), 0, capacityBytes + alignment);
+	}
+
+	const auto address = reinterpret_cast<std::uintptr_t> (memory.get());
+	auto*	   base	   = memory.get() + (alignment - address % alignment) % alignment;
+
+	for (auto& r : requests)
+	{
+		std::array<SampleType*, 2> channels {};
+
+		jassert (r.numChannels <= static_cast<int> (channels.size()));
+
+		for (auto chan = 0; chan < r.numChannels; ++chan)
+			channels[static_cast<size_t> (chan)] = reinterpret_cast<SampleType*> (base + r.offset + channelBytes * static_cast<size_t> (chan));
+
+		r.buffer->setDataToReferTo (channels.data(), r.numChannels, blocksize);
+	}
+}
+
+template class BufferArena<float>;
+template class BufferArena<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,63 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	One cache-line-aligned allocation that backs the engine's intermediate buffers.
+	Each buffer declares the range of engine stages it's alive for, and buffers whose lifetimes don't overlap
+	are given the same memory.
+*/
+template <typename SampleType>
+class BufferArena
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	// the stages of the engine's render callback, in the order they run
+	enum class Stage
+	{
+		preHarmony	= 0,
+		analysis	= 1,
+		harmony		= 2,
+		lead		= 3,
+		postHarmony = 4
+	};
+
+	void clear();
+
+	void request (AudioBuffer& buffer, int numChannels, Stage firstUse, Stage lastUse);
+
+	// plans the layout, and points each requested buffer into the arena. The memory is only reallocated if the new
+	// layout needs more than the arena has ever held, so a smaller blocksize or a repeat prepare reuses what's there
+	void allocate (int blocksize);
+
+	size_t getTotalBytes() const noexcept { return totalBytes; }
+
+	size_t getCapacityBytes() const noexcept { return capacityBytes; }
+
+private:
+
+	struct Request
+	{
+		AudioBuffer* buffer;
+		int			 numChannels;
+		int			 firstUse, lastUse;
+		size_t		 offset;
+	};
+
+	static constexpr size_t alignment = 64;
+
+	std::vector<Request> requests;
+
+	// scratch space for planning the layout, kept between prepares
+	std::vector<Request*>		sorted;
+	std::vector<const Request*> placed;
+
+	juce::HeapBlock<char> memory;
+
+	size_t totalBytes { 0 };
+	size_t capacityBytes { 0 };
+};
+
+}  // namespace Imogen
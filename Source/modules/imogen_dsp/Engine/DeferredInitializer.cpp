@@ -0,0 +1,37 @@
+
+namespace Imogen
+{
+DeferredInitializer::DeferredInitializer()
+	: juce::Thread ("Imogen deferred initializer")
+{
+}
+
+DeferredInitializer::~DeferredInitializer()
+{
+	waitForCompletion();
+}
+
+void DeferredInitializer::launch (Job&& jobToRun)
+{
+	waitForCompletion();
+
+	job = std::move (jobToRun);
+
+	startThread();
+}
+
+void DeferredInitializer::waitForCompletion()
+{
+	// the job can't be interrupted partway through, so this waits for as long as it takes
+	stopThread (-1);
+
+	job = nullptr;
+}
+
+void DeferredInitializer::run()
+{
+	if (job)
+		job();
+}
+
+}  // namespace Imogen
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	Runs a one-off job on a background thread, so that slow setup work doesn't hold up the thread that asked for it.
+	Whoever owns the job's data must call waitForCompletion() before touching it again.
+*/
+class DeferredInitializer : private juce::Thread
+{
+public:
+
+	using Job = std::function<void()>;
+
+	DeferredInitializer();
+
+	~DeferredInitializer() override;
+
+	void launch (Job&& jobToRun);
+
+	void waitForCompletion();
+
+private:
+
+	void run() final;
+
+	Job job;
+};
+
+}  // namespace Imogen
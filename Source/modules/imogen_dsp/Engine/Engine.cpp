@@ -6,59 +6,621 @@ Engine<SampleType>::Engine (State& stateToUse)
 {
 }
 
+template <typename SampleType>
+Engine<SampleType>::Processors::Processors (State& stateToUse)
+	: state (stateToUse)
+{
+	setNumSingers (1);
+}
+
+template <typename SampleType>
+Engine<SampleType>::Singer::Singer (State& stateToUse, int index)
+	: state (stateToUse)
+{
+	// the singers render on different threads, so only one of them can report what it's hearing
+	voicing.setPublishesInternals (index == 0);
+	harmonizer.setPublishesInternals (index == 0);
+	preHarmonyEffects.setPublishesMeters (index == 0);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::Processors::setNumSingers (int numSingers)
+{
+	jassert (numSingers > 0);
+
+	const auto newSize = static_cast<size_t> (numSingers);
+
+	if (singers.size() > newSize)
+		singers.resize (newSize);
+
+	while (singers.size() < newSize)
+		singers.emplace_back (std::make_unique<Singer> (state, static_cast<int> (singers.size())));
+}
+
+template <typename SampleType>
+bool Engine<SampleType>::Processors::isInitialized() const
+{
+	return std::all_of (singers.begin(), singers.end(),
+						[] (const auto& singer)
+						{ return singer->harmonizer.isInitialized(); });
+}
+
 template <typename SampleType>
 void Engine<SampleType>::renderChunk (const AudioBuffer& input, AudioBuffer& output, MidiBuffer& midiMessages, bool)
 {
-	output.clear();
+	if (! isReady.load (std::memory_order_acquire))
+	{
+		output.clear();
+		return;
+	}
+
+	const auto startTicks = juce::Time::getHighResolutionTicks();
+
+	// there's no deadline to keep when rendering offline
+	const auto isNonRealtime = state.internals.isNonRealtime.load();
+
+	// when the host's blocks are shorter than a chunk, the whole chunk is rendered inside one of them, so that's the
+	// time it really has
+	const auto hostBlocksize = state.internals.hostBlocksize.load (std::memory_order_relaxed);
+	const auto budget		 = hostBlocksize > 0 ? std::min (input.getNumSamples(), hostBlocksize) : input.getNumSamples();
+
+	const auto budgetTicks = juce::Time::getHighResolutionTicksPerSecond() * budget / preparedSettings.samplerate;
+
+	chunkDeadlineTicks = isNonRealtime ? std::numeric_limits<juce::int64>::max()
+									   : startTicks + static_cast<juce::int64> (budgetTicks * singerDeadlineFraction);
+
+	processChunk (input, output, midiMessages);
+
+	if (isNonRealtime)
+		return;
+
+	const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+	if (loadGovernor.blockRendered (budget, seconds))
+		applyQualityTier (loadGovernor.getTier());
+}
+
+template <typename SampleType>
+void Engine<SampleType>::processChunk (const AudioBuffer& input, AudioBuffer& output, MidiBuffer& midiMessages)
+{
 	updateStereoWidth (parameters.stereoWidth->get());
 
-	const bool leadIsBypassed		= parameters.leadBypass->get();
-	const bool harmoniesAreBypassed = parameters.harmonyBypass->get();
+	auto& p = *processors;
+
+	// while the processor is monitoring the lead dry, the engine's own, delayed copy of it would only smear it.
+	// Worked out once per chunk, so that every singer sees the same
+	p.leadIsBypassed	   = parameters.leadBypass->get() || state.internals.isMonitoringDry.load (std::memory_order_relaxed);
+	p.harmoniesAreBypassed = parameters.harmonyBypass->get();
 
 	const auto numSamples = input.getNumSamples();
 
-	if (leadIsBypassed && harmoniesAreBypassed)
+	// each singer takes its own channel of the main input, so there can't be more of them than there are channels
+	const auto numSingers = juce::jlimit (1, static_cast<int> (p.singers.size()), getNumMainInputChannels (input));
+
+	if (p.leadIsBypassed && p.harmoniesAreBypassed)
 	{
-		harmonizer.bypassedBlock (numSamples, midiMessages);
+		output.clear();
+
+		if (numSingers > 1)
+		{
+			splitMidi (midiMessages, numSingers);
+
+			WorkerPool::JobMask rendered = 0;
+
+			for (auto i = 0; i < numSingers; ++i)
+			{
+				if (p.workers.isBusy (i))
+					continue;
+
+				p.singers[static_cast<size_t> (i)]->harmonizer.bypassedBlock (numSamples, p.singers[static_cast<size_t> (i)]->midi);
+				rendered |= WorkerPool::JobMask (1) << i;
+			}
+
+			mergeMidi (midiMessages, numSingers, rendered);
+		}
+		else
+		{
+			p.singers.front()->harmonizer.bypassedBlock (numSamples, midiMessages);
+		}
+
 		return;
 	}
 
-	preHarmonyEffects.process (input);
+	auto& firstSinger = *p.singers.front();
+
+	if (numSingers > 1)
+		renderSingers (input, output, midiMessages, numSingers);
+	else
+		renderSinger (firstSinger, input, -1, output, midiMessages);
+
+	p.postHarmonyEffects.process (output, *firstSinger.lead);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::renderSinger (Singer& singer, const AudioBuffer& input, int channel,
+									   AudioBuffer& harmonyOutput, MidiBuffer& midiMessages)
+{
+	const auto& p = *processors;
+
+	const auto numSamples = input.getNumSamples();
+
+	const auto* analysisInput	  = getAnalysisInput (singer, input, channel);
+	auto		harmonyNumSamples = numSamples;
+
+	// the voices render straight into the harmony output, and the post-harmony chain later runs on it in place.
+	// If the harmony path is resampled, the voices render at the lower rate and are brought back up into it
+	auto* harmonyBus = &harmonyOutput;
+
+	if (singer.resampler.isEnabled())
+	{
+		harmonyNumSamples = numSamples / singer.resampler.getFactor();
+		analysisInput	  = singer.resampler.downsampleInput (analysisInput, numSamples);
+		harmonyBus		  = &singer.resampler.getHarmonyBuffer (harmonyNumSamples);
+	}
+
+	singer.analyzer.analyzeInput (analysisInput, harmonyNumSamples);
+
+	singer.voicing.setPassthroughEnabled (parameters.engineState.unvoicedPassthrough->get());
+	singer.voicing.analyze (analysisInput, harmonyNumSamples);
+
+	singer.harmonizer.process (*harmonyBus, midiMessages, p.harmoniesAreBypassed);
+
+	if (singer.resampler.isEnabled())
+		singer.resampler.upsampleHarmony (harmonyOutput);
+
+	singer.leadProcessor.process (p.leadIsBypassed, harmonyNumSamples);
+
+	singer.lead = &singer.leadProcessor.getProcessedSignal();
+
+	if (singer.resampler.isEnabled())
+		singer.lead = &singer.resampler.upsampleLead (*singer.lead);
+}
+
+template <typename SampleType>
+const SampleType* Engine<SampleType>::getAnalysisInput (Singer& singer, const AudioBuffer& input, int channel)
+{
+	// a dedicated source, like a DI mic or a guide vocal, is already clean and mono, so it skips the input stages.
+	// With several singers, it stands in for the first one
+	if (channel <= 0)
+		if (const auto sidechain = getSidechainChannel (input); sidechain >= 0)
+		{
+			const auto* source = input.getReadPointer (sidechain);
+
+			singer.preHarmonyEffects.skip (source, input.getNumSamples());
+
+			return source;
+		}
+
+	if (channel < 0)
+	{
+		if (const auto numMainChannels = getNumMainInputChannels (input); numMainChannels < input.getNumChannels())
+		{
+			// the sidechain comes after the main input's channels, and shouldn't be mixed into it
+			singer.inputAlias.setDataToReferTo (const_cast<SampleType**> (input.getArrayOfReadPointers()),
+												numMainChannels, input.getNumSamples());
+
+			singer.preHarmonyEffects.process (singer.inputAlias);
+		}
+		else
+		{
+			singer.preHarmonyEffects.process (input);
+		}
+	}
+	else
+	{
+		// only ever read from, despite the cast
+		singer.inputAlias.setDataToReferTo (const_cast<SampleType**> (input.getArrayOfReadPointers() + channel),
+											1, input.getNumSamples());
+
+		singer.preHarmonyEffects.process (singer.inputAlias);
+	}
+
+	return singer.preHarmonyEffects.getProcessedInputSignal();
+}
+
+template <typename SampleType>
+int Engine<SampleType>::getNumMainInputChannels (const AudioBuffer& input) const
+{
+	// the sidechain's channels follow the main input's. With the main input disabled, the sidechain is all there is
+	if (const auto sidechain = getSidechainChannel (input); sidechain > 0)
+		return sidechain;
+
+	return input.getNumChannels();
+}
+
+template <typename SampleType>
+int Engine<SampleType>::getSidechainChannel (const AudioBuffer& input) const
+{
+	// otherwise the sidechain's channel is treated like any other input channel
+	if (! parameters.sidechainAnalysis->get())
+		return -1;
+
+	if (const auto sidechain = state.internals.sidechainChannel.load(); sidechain < input.getNumChannels())
+		return sidechain;
+
+	return -1;
+}
+
+template <typename SampleType>
+void Engine<SampleType>::renderSingers (const AudioBuffer& input, AudioBuffer& output, MidiBuffer& midiMessages, int numSingers)
+{
+	auto& p = *processors;
+
+	splitMidi (midiMessages, numSingers);
+
+	p.blockInput  = &input;
+	p.blockOutput = &output;
+
+	const auto rendered = p.workers.run (numSingers, chunkDeadlineTicks);
+
+	const auto numSamples = input.getNumSamples();
+
+	auto& firstLead = *p.singers.front()->lead;
+
+	for (auto i = 1; i < numSingers; ++i)
+	{
+		// a singer that missed the deadline is left out of this chunk
+		if ((rendered & (WorkerPool::JobMask (1) << i)) == 0)
+			continue;
+
+		const auto& singer = *p.singers[static_cast<size_t> (i)];
+
+		for (auto chan = 0; chan < output.getNumChannels(); ++chan)
+			output.addFrom (chan, 0, singer.harmonyAlias, chan, 0, numSamples);
+
+		for (auto chan = 0; chan < firstLead.getNumChannels(); ++chan)
+			firstLead.addFrom (chan, 0, *singer.lead, chan, 0, numSamples);
+	}
+
+	mergeMidi (midiMessages, numSingers, rendered);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::renderSingerJob (int index)
+{
+	auto& p		 = *processors;
+	auto& singer = *p.singers[static_cast<size_t> (index)];
+
+	const auto& input = *p.blockInput;
+
+	auto* harmonyOutput = p.blockOutput;
+
+	if (index > 0)
+	{
+		singer.harmonyAlias.setDataToReferTo (singer.harmonyBuffer.getArrayOfWritePointers(), 2, input.getNumSamples());
+		harmonyOutput = &singer.harmonyAlias;
+	}
+
+	renderSinger (singer, input, index, *harmonyOutput, singer.midi);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::splitMidi (MidiBuffer& midiMessages, int numSingers)
+{
+	auto& p		  = *processors;
+	auto& singers = p.singers;
+
+	for (auto i = 0; i < numSingers; ++i)
+	{
+		auto& singer = *singers[static_cast<size_t> (i)];
+
+		// the worker is still writing into it
+		if (p.workers.isBusy (i))
+			continue;
+
+		singer.midi.clear();
+
+		// whatever arrived while it was busy comes first, at the start of the chunk
+		for (const auto meta : singer.deferredMidi)
+			singer.midi.addEvent (meta.data, meta.numBytes, 0);
+
+		singer.deferredMidi.clear();
+	}
+
+	for (const auto meta : midiMessages)
+	{
+		const auto status = meta.data[0];
+
+		// messages that aren't on a channel go to the first singer
+		const auto index = (status & 0xf0) == 0xf0 ? 0 : (status & 0x0f) % numSingers;
+
+		auto& singer = *singers[static_cast<size_t> (index)];
 
-	analyzer.analyzeInput (preHarmonyEffects.getProcessedInputSignal(), numSamples);
+		auto& destination = p.workers.isBusy (index) ? singer.deferredMidi : singer.midi;
 
-	harmonizer.process (numSamples, midiMessages, harmoniesAreBypassed);
+		destination.addEvent (meta.data, meta.numBytes, meta.samplePosition);
+	}
 
-	leadProcessor.process (leadIsBypassed, numSamples);
+	midiMessages.clear();
+}
 
-	postHarmonyEffects.process (harmonizer.getHarmonySignal(), leadProcessor.getProcessedSignal(), output);
+template <typename SampleType>
+void Engine<SampleType>::mergeMidi (MidiBuffer& midiMessages, int numSingers, WorkerPool::JobMask rendered)
+{
+	for (auto i = 0; i < numSingers; ++i)
+		if ((rendered & (WorkerPool::JobMask (1) << i)) != 0)
+			midiMessages.addEvents (processors->singers[static_cast<size_t> (i)]->midi, 0, -1, 0);
 }
 
 template <typename SampleType>
 void Engine<SampleType>::updateStereoWidth (int width)
 {
-	harmonizer.panner.updateStereoWidth (width);
-	postHarmonyEffects.updateStereoWidth (width);
+	for (auto& singer : processors->singers)
+		singer->harmonizer.panner.updateStereoWidth (width);
+
+	processors->postHarmonyEffects.updateStereoWidth (width);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::applyQualityTier (LoadGovernor::Tier tier)
+{
+	auto maxVoices	= std::numeric_limits<int>::max();
+	auto lowCpuMode = true;
+
+	switch (tier)
+	{
+		case (LoadGovernor::Tier::reduced) :
+			maxVoices = 8;
+			break;
+
+		case (LoadGovernor::Tier::minimal) :
+			maxVoices = 4;
+			break;
+
+		default :
+			lowCpuMode = false;
+			break;
+	}
+
+	for (auto& singer : processors->singers)
+		singer->harmonizer.setMaxActiveVoices (maxVoices);
+
+	processors->postHarmonyEffects.setLowCpuMode (lowCpuMode);
+
+	state.internals.cpuQualityTier->set (static_cast<int> (tier));
 }
 
 template <typename SampleType>
 void Engine<SampleType>::onPrepare (int blocksize, double samplerate)
 {
-	if (! harmonizer.isInitialized())
-		harmonizer.initialize (16, samplerate, blocksize);
+	// a deferred initialization from an earlier prepare, or a singer still rendering after missing its deadline, has to
+	// finish before anything is touched again
+	initializer.waitForCompletion();
+
+	if (processors != nullptr)
+		processors->workers.waitUntilIdle();
 
-	analyzer.prepare (samplerate, blocksize);
+	const PrepareSettings settings { samplerate, blocksize,
+									 state.internals.isNonRealtime.load(),
+									 parameters.engineState.pipelinedEffects->get(),
+									 parameters.engineState.internalResampling->get(),
+									 parameters.engineState.limiterTruePeak->get(),
+									 parameters.engineState.numSingers->get(),
+									 EngineState::getLowestPitchHz (parameters.engineState.voiceRange->get()) };
 
-	if (const auto latency = analyzer.getLatencySamples() > 0)
+	// some hosts re-prepare on every transport start. If nothing that sizes the processors has grown, they keep their
+	// memory, and only their state is cleared so that no stale tails are played from the last run
+	if (isReady.load (std::memory_order_acquire) && settings.fitsWithin (preparedSettings))
 	{
-		dsp::LatencyEngine<SampleType>::changeLatency (latency);
+		// this also restarts the LatencyEngine's FIFOs
+		if (preparedChunkSize > 0)
+			dsp::LatencyEngine<SampleType>::changeLatency (preparedChunkSize);
+
+		resetProcessors (samplerate, preparedChunkSize > 0 ? preparedChunkSize : preparedSettings.blocksize);
+
+		return;
+	}
+
+	isReady.store (false, std::memory_order_release);
+
+	preparedSettings = settings;
+
+	// the first prepare is where this engine's precision turns out to be the one in use
+	if (processors == nullptr)
+		processors = std::make_unique<Processors> (state);
+
+	auto& p = *processors;
+
+	p.setNumSingers (settings.numSingers);
+
+	const auto resamplingStages = settings.internalResampling ? HarmonyResampler<SampleType>::getNumStagesFor (samplerate, minHarmonySamplerate) : 0;
+
+	for (auto& singer : p.singers)
+		singer->resampler.setNumStages (resamplingStages);
+
+	auto& firstSinger = *p.singers.front();
+
+	const auto factor = firstSinger.resampler.getFactor();
+
+	// the voice range sets the longest period the analyzer has to find, which sets its window, and with it most of the
+	// engine's latency
+	for (auto& singer : p.singers)
+	{
+		singer->analyzer.setMinInputFreq (settings.lowestPitchHz);
+		singer->analyzer.prepare (samplerate / factor, (blocksize + factor - 1) / factor);
+	}
+
+	// offline bounces can afford the heavier processing, and the added latency
+	p.postHarmonyEffects.configure (samplerate, settings.isNonRealtime);
+
+	// an offline render doesn't run against the clock, so there's nothing to gain from the worker, and it'd only fall
+	// behind when the host hands over blocks faster than realtime
+	const auto pipelined = settings.pipelinedEffects && ! settings.isNonRealtime;
+
+	p.postHarmonyEffects.setPipelined (pipelined);
+
+	// the LatencyEngine delays by exactly the chunk size, and the analyzer's latency is all that the chunk has to cover.
+	// The analyzer reports it at the harmony path's rate
+	preparedChunkSize = getInternalBlocksize (firstSinger.analyzer.getLatencySamples() * factor, factor);
+
+	// the resampler and the limiter delay the signal inside each chunk, on top of the chunk delay itself
+	const auto processingLatency = firstSinger.resampler.getLatencySamples() + p.postHarmonyEffects.getLatencySamples();
+
+	// and the pipelined effects run a whole chunk behind the rest of the engine
+	const auto pipelineLatency = pipelined ? preparedChunkSize : 0;
+
+	const auto totalLatency = preparedChunkSize + processingLatency + pipelineLatency;
+
+	// the LatencyEngine only reports the chunk delay, so the processor reports this total to the host instead
+	state.internals.latencySamples.store (totalLatency);
+
+	state.internals.harmonyLatencyMs->set (juce::roundToInt (totalLatency * 1000. / samplerate));
+
+	if (preparedChunkSize > 0)
+	{
+		dsp::LatencyEngine<SampleType>::changeLatency (preparedChunkSize);
+		blocksize = preparedChunkSize;
+	}
+
+	// building the voice pool is the slow part of the first prepare, so when the host is running in realtime it's
+	// moved off the host's thread. An offline render needs every sample, so there it's done up front.
+	if (! p.isInitialized() && ! settings.isNonRealtime)
+	{
+		initializer.launch ([this, samplerate, blocksize]
+							{ prepareProcessors (samplerate, blocksize); });
 		return;
 	}
 
-	harmonizer.prepare (samplerate, blocksize);
-	leadProcessor.prepare (samplerate, blocksize);
-	preHarmonyEffects.prepare (samplerate, blocksize);
-	postHarmonyEffects.prepare (samplerate, blocksize);
+	prepareProcessors (samplerate, blocksize);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::prepareProcessors (double samplerate, int blocksize)
+{
+	auto& p = *processors;
+
+	const auto factor			 = p.singers.front()->resampler.getFactor();
+	const auto harmonySamplerate = samplerate / factor;
+	const auto harmonyBlocksize	 = blocksize / factor;
+
+	for (auto& singer : p.singers)
+	{
+		if (! singer->harmonizer.isInitialized())
+			singer->harmonizer.initialize (16, harmonySamplerate, harmonyBlocksize);
+
+		singer->harmonizer.setTimestampDivisor (factor);
+
+		singer->midi.ensureSize (midiScratchBytes);
+		singer->deferredMidi.ensureSize (midiScratchBytes);
+	}
+
+	resetProcessors (samplerate, blocksize);
+
+	allocateBuffers (blocksize);
+
+	// the first singer is rendered on the audio thread, and each of the others on its own worker
+	if (const auto numWorkers = static_cast<int> (p.singers.size()) - 1; numWorkers != p.workers.getNumWorkers())
+	{
+		if (numWorkers > 0)
+			p.workers.start (numWorkers, [this] (int index)
+							 { renderSingerJob (index); });
+		else
+			p.workers.stop();
+	}
+
+	loadGovernor.prepare (samplerate);
+	applyQualityTier (loadGovernor.getTier());
+
+	reportMemoryUsage();
+
+	isReady.store (true, std::memory_order_release);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::resetProcessors (double samplerate, int blocksize)
+{
+	auto& p = *processors;
+
+	const auto factor			 = p.singers.front()->resampler.getFactor();
+	const auto harmonySamplerate = samplerate / factor;
+	const auto harmonyBlocksize	 = blocksize / factor;
+
+	for (auto& singer : p.singers)
+	{
+		singer->voicing.prepare (harmonySamplerate);
+
+		singer->harmonizer.prepare (harmonySamplerate, harmonyBlocksize);
+		singer->leadProcessor.prepare (harmonySamplerate, harmonyBlocksize);
+		singer->resampler.prepare (blocksize);
+		singer->preHarmonyEffects.prepare (samplerate, blocksize);
+	}
+
+	p.postHarmonyEffects.prepare (samplerate, blocksize);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::allocateBuffers (int blocksize)
+{
+	auto& p = *processors;
+
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	for (auto i = 0; i < static_cast<int> (p.singers.size()); ++i)
+	{
+		auto& singer = *p.singers[static_cast<size_t> (i)];
+		auto& arena	 = i == 0 ? p.arena : singer.arena;
+
+		arena.clear();
+
+		singer.preHarmonyEffects.requestBuffers (arena);
+		singer.leadProcessor.requestBuffers (arena);
+		singer.resampler.requestBuffers (arena);
+
+		if (i > 0)
+		{
+			arena.request (singer.harmonyBuffer, 2, Stage::harmony, Stage::postHarmony);
+			arena.allocate (blocksize);
+		}
+	}
+
+	p.postHarmonyEffects.requestBuffers (p.arena);
+
+	p.arena.allocate (blocksize);
+}
+
+template <typename SampleType>
+void Engine<SampleType>::reportMemoryUsage()
+{
+	auto& p = *processors;
+
+	auto bytes = sizeof (Processors) + p.arena.getCapacityBytes();
+
+	for (const auto& singer : p.singers)
+		bytes += sizeof (Singer) + singer->arena.getCapacityBytes()
+			   + sizeof (HarmonizerVoice<SampleType>) * static_cast<size_t> (singer->harmonizer.getNumVoices());
+
+	const auto kb = static_cast<int> (bytes / 1024);
+
+	auto& internals = state.internals;
+
+	auto& ownShare = std::is_same_v<SampleType, float> ? internals.floatEngineMemoryKb : internals.doubleEngineMemoryKb;
+	ownShare.store (kb);
+
+	// the host only prepares one precision at a time, so the two engines never publish at once
+	internals.engineMemoryKb->set (internals.floatEngineMemoryKb.load() + internals.doubleEngineMemoryKb.load());
+}
+
+template <typename SampleType>
+bool Engine<SampleType>::PrepareSettings::fitsWithin (const PrepareSettings& prepared) const
+{
+	// the host's blocksize only sizes the analyzer, so a smaller one can be handled by what's already there
+	return samplerate == prepared.samplerate && blocksize <= prepared.blocksize
+		&& isNonRealtime == prepared.isNonRealtime && pipelinedEffects == prepared.pipelinedEffects
+		&& internalResampling == prepared.internalResampling && limiterTruePeak == prepared.limiterTruePeak
+		&& numSingers == prepared.numSingers && lowestPitchHz == prepared.lowestPitchHz;
+}
+
+template <typename SampleType>
+int Engine<SampleType>::getInternalBlocksize (int latency, int resamplingFactor) const
+{
+	// the LatencyEngine renders every chunk at this same size, whatever the host sends. A resampled harmony path also
+	// needs it to be a whole number of its own samples
+	if (resamplingFactor == 1)
+		return latency;
+
+	const auto numFrames = std::max (1, (latency + resamplingFactor - 1) / resamplingFactor);
+
+	return numFrames * resamplingFactor;
 }
 
 
@@ -2,9 +2,13 @@
 
 #include <imogen_state/imogen_state.h>
 
+#include "LoadGovernor.h"
+#include "DeferredInitializer.h"
+#include "WorkerPool.h"
 #include "Lead/LeadProcessor.h"
 #include "effects/PostHarmonyEffects.h"
 #include "effects/PreHarmonyEffects.h"
+#include "Resampling/HarmonyResampler.h"
 
 namespace Imogen
 {
@@ -23,20 +27,160 @@ private:
 
 	void onPrepare (int blocksize, double samplerate) final;
 
+	void processChunk (const AudioBuffer& input, AudioBuffer& output, MidiBuffer& midiMessages);
+
+	struct Singer;
+
+	// runs one singer's whole harmony path. channel is the input channel the singer takes, or -1 for the whole input
+	void renderSinger (Singer& singer, const AudioBuffer& input, int channel, AudioBuffer& harmonyOutput, MidiBuffer& midiMessages);
+
+	// runs the input stages, unless the sidechain is being analyzed instead
+	const SampleType* getAnalysisInput (Singer& singer, const AudioBuffer& input, int channel);
+
+	int getNumMainInputChannels (const AudioBuffer& input) const;
+
+	// the sidechain's channel in the input, or -1 if it isn't there or isn't being analyzed
+	int getSidechainChannel (const AudioBuffer& input) const;
+
+	void renderSingers (const AudioBuffer& input, AudioBuffer& output, MidiBuffer& midiMessages, int numSingers);
+
+	void renderSingerJob (int index);
+
+	// in multi-singer mode, MIDI channel N drives singer N, wrapping around if there are fewer singers than channels.
+	// A singer whose worker is still busy with an earlier chunk keeps its messages until it's free again, and only the
+	// singers that were rendered have their output merged back
+	void splitMidi (MidiBuffer& midiMessages, int numSingers);
+	void mergeMidi (MidiBuffer& midiMessages, int numSingers, WorkerPool::JobMask rendered);
+
 	void updateStereoWidth (int width);
 
+	void applyQualityTier (LoadGovernor::Tier tier);
+
+	void prepareProcessors (double samplerate, int blocksize);
+
+	// every processor's prepare clears its state, and at sizes it has already been prepared for, doesn't allocate
+	void resetProcessors (double samplerate, int blocksize);
+
+	void allocateBuffers (int blocksize);
+
+	int getInternalBlocksize (int latency, int resamplingFactor) const;
+
+	void reportMemoryUsage();
+
+	// with internal resampling on, the harmony path is brought down to the lowest rate at or above this
+	static constexpr auto minHarmonySamplerate = 44100.;
+
+	// bytes reserved in each singer's MIDI buffer, so that splitting never allocates
+	static constexpr auto midiScratchBytes = 4096;
+
+	// how much of a chunk's time the other singers can take, leaving the rest for the post-harmony effects
+	static constexpr auto singerDeadlineFraction = 0.75;
+
+	/*
+		One singer's analysis and harmony stack. There's normally just the one, but in multi-singer mode each input
+		channel gets its own, and they're all rendered in parallel into the same post-harmony effects.
+	*/
+	struct Singer
+	{
+		Singer (State& stateToUse, int index);
+
+		State& state;
+
+		dsp::psola::Analyzer<SampleType> analyzer;
+
+		VoicingDetector<SampleType> voicing { state.internals };
+
+		PreHarmonyEffects<SampleType> preHarmonyEffects { state };
+
+		Harmonizer<SampleType> harmonizer { state, analyzer, voicing };
+
+		LeadProcessor<SampleType> leadProcessor { harmonizer, state };
+
+		HarmonyResampler<SampleType> resampler;
+
+		// the first singer's buffers live in the engine's arena. The others are rendered at the same time as it, so
+		// they can't share its memory and each get their own
+		BufferArena<SampleType> arena;
+
+		// every singer but the first renders its harmony here, to be summed into the output
+		AudioBuffer harmonyBuffer, harmonyAlias;
+
+		AudioBuffer inputAlias;
+
+		MidiBuffer midi;
+
+		// messages that arrived while this singer's worker was still busy
+		MidiBuffer deferredMidi;
+
+		// the rendered lead, valid until the next block
+		AudioBuffer* lead { nullptr };
+	};
+
+	/*
+		Everything with a real memory footprint lives in here. The processor holds an engine for each precision, but only
+		the one the host actually prepares ever builds its Processors.
+	*/
+	struct Processors
+	{
+		Processors (State& stateToUse);
+
+		void setNumSingers (int numSingers);
+
+		bool isInitialized() const;
+
+		State& state;
+
+		std::vector<std::unique_ptr<Singer>> singers;
+
+		PostHarmonyEffects<SampleType> postHarmonyEffects { state };
+
+		BufferArena<SampleType> arena;
+
+		// renders every singer after the first
+		WorkerPool workers;
+
+		// the block the workers are rendering, and what's bypassed in it
+		const AudioBuffer* blockInput { nullptr };
+		AudioBuffer*	   blockOutput { nullptr };
+		bool			   leadIsBypassed { false };
+		bool			   harmoniesAreBypassed { false };
+	};
+
 	State&		state;
 	Parameters& parameters { state.parameters };
 
-	dsp::psola::Analyzer<SampleType> analyzer;
+	std::unique_ptr<Processors> processors;
+
+	LoadGovernor loadGovernor;
+
+	// when the singers rendering on the workers are given up on for the current chunk
+	juce::int64 chunkDeadlineTicks { 0 };
+
+	// everything the processors' preparation depends on
+	struct PrepareSettings
+	{
+		double samplerate { 0. };
+		int	   blocksize { 0 };
+		bool   isNonRealtime { false };
+		bool   pipelinedEffects { false };
+		bool   internalResampling { false };
+		bool   limiterTruePeak { false };
+		int	   numSingers { 1 };
+		int	   lowestPitchHz { 0 };
+
+		bool fitsWithin (const PrepareSettings& prepared) const;
+	};
 
-	PreHarmonyEffects<SampleType> preHarmonyEffects { state };
+	PrepareSettings preparedSettings;
 
-	Harmonizer<SampleType> harmonizer { state, analyzer };
+	// the chunk size last passed to changeLatency, or 0 if it wasn't called
+	int preparedChunkSize { 0 };
 
-	LeadProcessor<SampleType> leadProcessor { harmonizer, state };
+	// false until the processors have been fully prepared; until then the engine outputs silence
+	std::atomic<bool> isReady { false };
 
-	PostHarmonyEffects<SampleType> postHarmonyEffects { state };
+	// declared last so that a running job is finished before anything it uses is destroyed
+	DeferredInitializer initializer;
 };
 
 }  // namespace Imogen
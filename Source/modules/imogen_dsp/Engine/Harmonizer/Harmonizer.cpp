@@ -2,10 +2,10 @@
 namespace Imogen
 {
 template <typename SampleType>
-Harmonizer<SampleType>::Harmonizer (State& stateToUse, Analyzer& analyzerToUse)
+Harmonizer<SampleType>::Harmonizer (State& stateToUse, Analyzer& analyzerToUse, VoicingDetector<SampleType>& voicingToUse)
 	: dsp::LambdaSynth<SampleType> ([this]
-									{ return new Voice (*this, analyzer); }),
-	  analyzer (analyzerToUse), state (stateToUse)
+									{ return new Voice (*this, analyzer, numVoicesCreated++); }),
+	  analyzer (analyzerToUse), voicing (voicingToUse), state (stateToUse)
 {
 	this->updateQuickReleaseMs (5);
 
@@ -14,76 +14,320 @@ Harmonizer<SampleType>::Harmonizer (State& stateToUse, Analyzer& analyzerToUse)
 }
 
 template <typename SampleType>
-void Harmonizer<SampleType>::prepared (double, int blocksize)
+Harmonizer<SampleType>::~Harmonizer()
 {
-	wetBuffer.setSize (2, blocksize, true, true, true);
+	internals.removeTuningSource (this);
 }
 
 template <typename SampleType>
-void Harmonizer<SampleType>::process (int numSamples, MidiBuffer& midiMessages,
+void Harmonizer<SampleType>::setPublishesInternals (bool shouldPublish)
+{
+	publishesInternals = shouldPublish;
+
+	if (shouldPublish)
+		internals.setTuningSource (this);
+	else
+		internals.removeTuningSource (this);
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::prepared (double samplerate, int blocksize)
+{
+	subBlockMidi.ensureSize (midiScratchBytes);
+	midiOutput.ensureSize (midiScratchBytes);
+
+	const auto numVoices = std::max (1, this->getNumVoices());
+
+	renderingStorage.setSize (numVoices, blocksize, false, false, true);
+
+	// at least twice as many slots as there can be renderings, so that probes stay short
+	const auto numSlots = static_cast<size_t> (juce::nextPowerOfTwo (numVoices * 2));
+
+	renderings.assign (numSlots, Rendering {});
+	renderingsMask = numSlots - 1;
+	numRenderings  = 0;
+
+	voicePriorities.assign (static_cast<size_t> (numVoices), 0);
+	numVoicesReported = 0;
+	numVoicesSounding = 1;
+	priorityThreshold = 0;
+
+	// the voices may have been rebuilt, so everything is pushed again on the next block
+	settingsArePushed = false;
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::process (AudioBuffer& output, MidiBuffer& midiMessages,
 									  bool harmoniesBypassed)
 {
 	if (harmoniesBypassed)
 	{
-		wetBuffer.clear();
-		this->bypassedBlock (numSamples, midiMessages);
+		output.clear();
+		this->bypassedBlock (output.getNumSamples(), midiMessages);
 	}
 	else
 	{
-		updateParameters();
-		this->renderVoices (midiMessages, wetBuffer);
+		renderSubBlocks (output, midiMessages);
 	}
 
 	updateInternals();
-	lastBlocksize = numSamples;
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::renderSubBlocks (AudioBuffer& output, MidiBuffer& midiMessages)
+{
+	const auto numSamples = output.getNumSamples();
+
+	midiOutput.clear();
+
+	auto	   event = midiMessages.cbegin();
+	const auto end	 = midiMessages.cend();
+
+	auto startSample = 0;
+
+	// the parameters can't change partway through a block, so they're only checked once for all its sub-blocks
+	updateParameters();
+
+	while (startSample < numSamples)
+	{
+		subBlockMidi.clear();
+
+		auto endSample = numSamples;
+
+		for (; event != end; ++event)
+		{
+			const auto meta		= *event;
+			const auto position = juce::jlimit (0, numSamples - 1, meta.samplePosition / timestampDivisor);
+			const auto offset	= std::max (0, position - startSample);
+
+			// a voice can only tell where it is in the block from how much it has rendered since the sub-block began, so
+			// every note-on starts a sub-block of its own. Other events are handled by the synth at their exact offset,
+			// and only split the block when the sub-block before them would be long enough to be worth it
+			if (offset >= (startsNote (meta) ? minNoteOnSpacing : minSubBlockSize))
+			{
+				endSample = position;
+				break;
+			}
+
+			// a note-on this close to the sub-block's start is moved back to it, rather than starting a tiny sub-block, so
+			// that a burst of notes can't split the block without limit. Everything else this close is moved with it, to
+			// stay in order
+			subBlockMidi.addEvent (meta.data, meta.numBytes, offset < minNoteOnSpacing ? 0 : offset);
+		}
+
+		const auto subBlockSize = endSample - startSample;
+
+		subBlockAlias.setDataToReferTo (output.getArrayOfWritePointers(), 2, startSample, subBlockSize);
+
+		updateVoiceCulling();
+
+		nextRenderPass();
+		subBlockStart = startSample;
+		numRenderings = 0;
+
+		this->renderVoices (subBlockMidi, subBlockAlias);
+
+		for (const auto meta : subBlockMidi)
+			midiOutput.addEvent (meta.data, meta.numBytes, (meta.samplePosition + startSample) * timestampDivisor);
+
+		startSample = endSample;
+	}
+
+	midiMessages.clear();
+	midiMessages.addEvents (midiOutput, 0, numSamples * timestampDivisor, 0);
+}
+
+template <typename SampleType>
+bool Harmonizer<SampleType>::startsNote (const juce::MidiMessageMetadata& meta) noexcept
+{
+	// a note-on with velocity 0 is a note-off
+	return meta.numBytes >= 3 && (meta.data[0] & 0xf0) == 0x90 && meta.data[2] > 0;
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::nextRenderPass() noexcept
+{
+	if (++renderPass != 0)
+		return;
+
+	// entries stamped in the passes just before the wrap would otherwise look current again, 2^32 passes later
+	std::fill (renderings.begin(), renderings.end(), Rendering {});
+	renderPass = 1;
 }
 
 template <typename SampleType>
 void Harmonizer<SampleType>::updateParameters()
 {
-	this->setMidiLatch (midi.midiLatch->get());
+	SynthSettings next;
+
+	next.midiLatch		  = midi.midiLatch->get();
+	next.adsrAttack		  = midi.adsrAttack->get();
+	next.adsrDecay		  = midi.adsrDecay->get();
+	next.adsrSustain	  = static_cast<float> (midi.adsrSustain->get()) * 0.01f;
+	next.adsrRelease	  = midi.adsrRelease->get();
+	next.pedalToggle	  = midi.pedalToggle->get();
+	next.pedalThresh	  = midi.pedalThresh->get();
+	next.pedalInterval	  = midi.pedalInterval->get();
+	next.descantToggle	  = midi.descantToggle->get();
+	next.descantThresh	  = midi.descantThresh->get();
+	next.descantInterval  = midi.descantInterval->get();
+	next.voiceStealing	  = midi.voiceStealing->get();
+	next.aftertouchToggle = midi.aftertouchToggle->get();
+	next.velocitySens	  = midi.velocitySens->get();
+	next.pitchbendRange	  = midi.pitchbendRange->get();
+	next.lowestPanned	  = parameters.lowestPanned->get();
+	next.pitchGlide		  = midi.pitchGlide->get();
+	next.glideTime		  = midi.glideTime->get();
+
+	// most of these fan out to every voice, and this runs for every sub-block, so each one is only passed on to the
+	// synth when it has actually changed
+	const auto changed = [&next, this, force = ! settingsArePushed] (auto... members)
+	{ return force || ((next.*members != pushedSettings.*members) || ...); };
+
+	if (changed (&SynthSettings::midiLatch))
+		this->setMidiLatch (next.midiLatch);
 
-	this->updateADSRsettings (midi.adsrAttack->get(),
-							  midi.adsrDecay->get(),
-							  static_cast<float> (midi.adsrSustain->get()) * 0.01f,
-							  midi.adsrRelease->get());
+	if (changed (&SynthSettings::adsrAttack, &SynthSettings::adsrDecay, &SynthSettings::adsrSustain, &SynthSettings::adsrRelease))
+		this->updateADSRsettings (next.adsrAttack, next.adsrDecay, next.adsrSustain, next.adsrRelease);
 
-	this->pedal.setParams (midi.pedalToggle->get(),
-						   midi.pedalThresh->get(),
-						   midi.pedalInterval->get());
+	if (changed (&SynthSettings::pedalToggle, &SynthSettings::pedalThresh, &SynthSettings::pedalInterval))
+		this->pedal.setParams (next.pedalToggle, next.pedalThresh, next.pedalInterval);
 
-	this->descant.setParams (midi.descantToggle->get(),
-							 midi.descantThresh->get(),
-							 midi.descantInterval->get());
+	if (changed (&SynthSettings::descantToggle, &SynthSettings::descantThresh, &SynthSettings::descantInterval))
+		this->descant.setParams (next.descantToggle, next.descantThresh, next.descantInterval);
 
-	this->setNoteStealingEnabled (midi.voiceStealing->get());
-	this->setAftertouchGainOnOff (midi.aftertouchToggle->get());
+	if (changed (&SynthSettings::voiceStealing))
+		this->setNoteStealingEnabled (next.voiceStealing);
 
-	this->updateMidiVelocitySensitivity (midi.velocitySens->get());
+	if (changed (&SynthSettings::aftertouchToggle))
+		this->setAftertouchGainOnOff (next.aftertouchToggle);
 
-	this->updatePitchbendRange (midi.pitchbendRange->get());
+	if (changed (&SynthSettings::velocitySens))
+		this->updateMidiVelocitySensitivity (next.velocitySens);
 
-	this->panner.setLowestNote (parameters.lowestPanned->get());
+	if (changed (&SynthSettings::pitchbendRange))
+		this->updatePitchbendRange (next.pitchbendRange);
 
-	this->togglePitchGlide (midi.pitchGlide->get());
-	this->setPitchGlideTime (static_cast<double> (midi.glideTime->get()));
+	if (changed (&SynthSettings::lowestPanned))
+		this->panner.setLowestNote (next.lowestPanned);
+
+	if (changed (&SynthSettings::pitchGlide))
+		this->togglePitchGlide (next.pitchGlide);
+
+	if (changed (&SynthSettings::glideTime))
+		this->setPitchGlideTime (static_cast<double> (next.glideTime));
+
+	pushedSettings	  = next;
+	settingsArePushed = true;
+
+	unisonDetune = parameters.engineState.unisonDetune->get();
 }
 
 template <typename SampleType>
 void Harmonizer<SampleType>::updateInternals()
 {
+	if (! publishesInternals)
+		return;
+
 	auto ccInfo = this->getLastMovedControllerInfo();
 	internals.lastMovedMidiController->set (ccInfo.controllerNumber);
 	internals.lastMovedCCValue->set (ccInfo.controllerValue);
-	internals.mtsEspIsConnected->set (this->isConnectedToMtsEsp());
-	//    internals.mtsEspScaleName->set (this->getScaleName());
 }
 
 template <typename SampleType>
-AudioBuffer<SampleType>& Harmonizer<SampleType>::getHarmonySignal()
+const SampleType* Harmonizer<SampleType>::findRendering (float frequency, int startSample, int numSamples) const noexcept
+{
+	if (renderings.empty())
+		return nullptr;
+
+	for (auto slot = hashRendering (frequency, startSample, numSamples) & renderingsMask;;
+		 slot = (slot + 1) & renderingsMask)
+	{
+		const auto& rendering = renderings[slot];
+
+		if (rendering.renderPass != renderPass)
+			return nullptr;
+
+		if (rendering.frequency == frequency && rendering.startSample == startSample && rendering.numSamples == numSamples)
+			return renderingStorage.getReadPointer (rendering.channel);
+	}
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::storeRendering (float frequency, int startSample, const SampleType* samples, int numSamples) noexcept
+{
+	if (numRenderings >= renderingStorage.getNumChannels() || numSamples > renderingStorage.getNumSamples())
+		return;
+
+	auto slot = hashRendering (frequency, startSample, numSamples) & renderingsMask;
+
+	while (renderings[slot].renderPass == renderPass)
+		slot = (slot + 1) & renderingsMask;
+
+	renderings[slot] = { frequency, startSample, numSamples, renderPass, numRenderings };
+
+	juce::FloatVectorOperations::copy (renderingStorage.getWritePointer (numRenderings), samples, numSamples);
+
+	++numRenderings;
+}
+
+template <typename SampleType>
+size_t Harmonizer<SampleType>::hashRendering (float frequency, int startSample, int numSamples) noexcept
+{
+	std::uint32_t bits;
+	std::memcpy (&bits, &frequency, sizeof (bits));
+
+	auto hash = bits * 0x9e3779b1u;
+	hash ^= static_cast<std::uint32_t> (startSample) * 0x85ebca77u + static_cast<std::uint32_t> (numSamples);
+	hash ^= hash >> 16;
+
+	return static_cast<size_t> (hash);
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::setTimestampDivisor (int newDivisor)
 {
-	alias.setDataToReferTo (wetBuffer.getArrayOfWritePointers(), 2, lastBlocksize);
-	return alias;
+	jassert (newDivisor > 0);
+	timestampDivisor = newDivisor;
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::setMaxActiveVoices (int newMax)
+{
+	jassert (newMax > 0);
+	maxActiveVoices = newMax;
+}
+
+template <typename SampleType>
+void Harmonizer<SampleType>::updateVoiceCulling()
+{
+	// the voices are ranked on what they reported in the last pass. No two voices can tie, since every note has its own
+	// stamp, so exactly maxActiveVoices of them stay at or above the threshold
+	if (numVoicesReported <= maxActiveVoices)
+	{
+		priorityThreshold = 0;
+	}
+	else
+	{
+		const auto first = voicePriorities.begin();
+		const auto nth	 = first + (maxActiveVoices - 1);
+
+		std::nth_element (first, nth, first + numVoicesReported, std::greater<>());
+
+		priorityThreshold = *nth;
+	}
+
+	numVoicesSounding = juce::jlimit (1, maxActiveVoices, numVoicesReported);
+	numVoicesReported = 0;
+}
+
+template <typename SampleType>
+bool Harmonizer<SampleType>::reportVoicePriority (std::uint64_t priority) noexcept
+{
+	if (numVoicesReported < static_cast<int> (voicePriorities.size()))
+		voicePriorities[static_cast<size_t> (numVoicesReported++)] = priority;
+
+	return priority >= priorityThreshold;
 }
 
 
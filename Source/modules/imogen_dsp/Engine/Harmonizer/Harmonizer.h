@@ -4,13 +4,17 @@
 #include <lemons_synth/lemons_synth.h>
 #include <lemons_psola/lemons_psola.h>
 
+#include <imogen_dsp/Engine/Analysis/VoicingDetector.h>
+#include <imogen_dsp/Engine/Analysis/UnvoicedCrossfade.h>
+
+#include "MicroDetune.h"
 #include "HarmonizerVoice.h"
 
 
 namespace Imogen
 {
 template <typename SampleType>
-class Harmonizer : public dsp::LambdaSynth<SampleType>
+class Harmonizer : public dsp::LambdaSynth<SampleType>, private Internals::TuningSource
 {
 	using AudioBuffer = juce::AudioBuffer<SampleType>;
 	using Voice		  = HarmonizerVoice<SampleType>;
@@ -18,32 +22,157 @@ class Harmonizer : public dsp::LambdaSynth<SampleType>
 
 public:
 
-	Harmonizer (State& stateToUse, Analyzer& analyzerToUse);
+	Harmonizer (State& stateToUse, Analyzer& analyzerToUse, VoicingDetector<SampleType>& voicingToUse);
+
+	~Harmonizer() override;
+
+	// renders straight into output, which the post-harmony effects then process in place
+	void process (AudioBuffer& output,
+				  MidiBuffer&  midiMessages,
+				  bool		   harmoniesBypassed);
+
+	// voices beyond this many fade out, released notes before held ones and older notes before newer ones.
+	// Used by the engine's load governor
+	void setMaxActiveVoices (int newMax);
+
+	// when the harmony path runs at a fraction of the session rate, incoming MIDI timestamps are divided by this
+	void setTimestampDivisor (int newDivisor);
+
+	// counts up once per sub-block
+	std::uint32_t getRenderPass() const noexcept { return renderPass; }
+
+	// the most sub-blocks a block of this length can be split into, however dense its MIDI
+	static constexpr int getMaxSubBlocks (int numSamples) noexcept { return (numSamples + minNoteOnSpacing - 1) / minNoteOnSpacing; }
 
-	void process (int		  numSamples,
-				  MidiBuffer& midiMessages,
-				  bool		  harmoniesBypassed);
+	// each sounding voice reports its priority once per render pass. Returns false if the voice should fade out, because
+	// more voices are sounding than are allowed and it ranked below the rest in the last pass
+	bool reportVoicePriority (std::uint64_t priority) noexcept;
 
-	AudioBuffer& getHarmonySignal();
+	// how many voices were left sounding after culling in the last render pass; at least 1
+	int getNumVoicesSounding() const noexcept { return numVoicesSounding; }
+
+	// every note started gets a later stamp than the one before, so that newer notes can outrank older ones
+	std::uint64_t getNextNoteStamp() noexcept { return ++numNotesStamped; }
+
+	// where the sub-block being rendered starts, within the current analysis frame. Voices only ever start at the
+	// beginning of a sub-block, so a voice's position is this plus however much it has rendered in the sub-block so far
+	int getSubBlockStart() const noexcept { return subBlockStart; }
+
+	// voices that land on the same pitch over the same samples of a render pass share one rendering. startSample is
+	// the voice's true position in the analysis frame, which is only known because voices start at a sub-block's
+	// beginning. Returns nullptr if no voice has rendered this one yet
+	const SampleType* findRendering (float frequency, int startSample, int numSamples) const noexcept;
+	void			  storeRendering (float frequency, int startSample, const SampleType* samples, int numSamples) noexcept;
+
+	bool isUnisonDetuneEnabled() const noexcept { return unisonDetune; }
+
+	// with several singers, only the first one's harmonizer and lead write to the shared Internals. Publishing also
+	// makes this harmonizer the one polled for the MTS-ESP status, so the engine calls this for every harmonizer
+	void setPublishesInternals (bool shouldPublish);
+	bool isPublishingInternals() const noexcept { return publishesInternals; }
 
 	Analyzer& analyzer;
 
+	VoicingDetector<SampleType>& voicing;
+
 private:
 
 	void prepared (double samplerate, int blocksize) final;
 
+	void renderSubBlocks (AudioBuffer& output, MidiBuffer& midiMessages);
+
+	void updateVoiceCulling();
+
+	void nextRenderPass() noexcept;
+
+	static bool startsNote (const juce::MidiMessageMetadata& meta) noexcept;
+
 	void updateParameters();
 	void updateInternals();
 
+	// called from the processor's message thread timer
+	bool		 isMtsEspConnected() final { return this->isConnectedToMtsEsp(); }
+	juce::String getMtsEspScaleName() final { return this->getScaleName(); }
+
+	// the synth settings as they were last passed on to the synth
+	struct SynthSettings
+	{
+		bool  midiLatch { false };
+		float adsrAttack { 0.f }, adsrDecay { 0.f }, adsrSustain { 0.f }, adsrRelease { 0.f };
+		bool  pedalToggle { false };
+		int	  pedalThresh { 0 }, pedalInterval { 0 };
+		bool  descantToggle { false };
+		int	  descantThresh { 0 }, descantInterval { 0 };
+		bool  voiceStealing { false };
+		bool  aftertouchToggle { false };
+		int	  velocitySens { 0 };
+		int	  pitchbendRange { 0 };
+		int	  lowestPanned { 0 };
+		bool  pitchGlide { false };
+		float glideTime { 0.f };
+	};
+
+	// an open-addressed hash table entry. Entries from earlier render passes count as empty, so the table only needs
+	// clearing when the pass counter wraps around
+	struct Rendering
+	{
+		float		  frequency { 0.f };
+		int			  startSample { 0 }, numSamples { 0 };
+		std::uint32_t renderPass { 0 };
+		int			  channel { 0 };
+	};
+
+	static size_t hashRendering (float frequency, int startSample, int numSamples) noexcept;
+
+	// events other than note-ons closer together than this are rendered in the same sub-block
+	static constexpr auto minSubBlockSize = 32;
+
+	// note-ons closer than this to the start of a sub-block are moved back to it, which bounds the number of sub-blocks,
+	// and with it the block's worst-case render time, whatever MIDI arrives. 16 samples is a third of a millisecond
+	static constexpr auto minNoteOnSpacing = 16;
+
+	// bytes reserved in the scratch MIDI buffers, so that splitting never allocates
+	static constexpr auto midiScratchBytes = 4096;
+
 	State&		state;
 	Parameters& parameters { state.parameters };
 	MidiState&	midi { parameters.midiState };
 	Internals&	internals { state.internals };
 
-	AudioBuffer wetBuffer;
-	AudioBuffer alias;
+	AudioBuffer subBlockAlias;
+
+	MidiBuffer subBlockMidi;
+	MidiBuffer midiOutput;
+
+	int timestampDivisor { 1 };
+
+	int maxActiveVoices { std::numeric_limits<int>::max() };
+	int subBlockStart { 0 };
+
+	// counts up once per sub-block, wrapping around. 0 is never a live pass, so that it can mean none
+	std::uint32_t renderPass { 0 };
+
+	// the priorities reported in the current render pass, and the lowest one that may keep sounding in it
+	std::vector<std::uint64_t> voicePriorities;
+	int						   numVoicesReported { 0 };
+	int						   numVoicesSounding { 1 };
+	std::uint64_t			   priorityThreshold { 0 };
+	std::uint64_t			   numNotesStamped { 0 };
+
+	// one channel per voice, since at most every voice renders a different pitch
+	AudioBuffer			   renderingStorage;
+	std::vector<Rendering> renderings;
+	size_t				   renderingsMask { 0 };
+	int					   numRenderings { 0 };
+
+	bool unisonDetune { false };
+
+	bool publishesInternals { true };
+
+	SynthSettings pushedSettings;
+	bool		  settingsArePushed { false };
 
-	int lastBlocksize { 0 };
+	int numVoicesCreated { 0 };
 };
 
 
@@ -2,8 +2,8 @@
 namespace Imogen
 {
 template <typename SampleType>
-HarmonizerVoice<SampleType>::HarmonizerVoice (Harmonizer<SampleType>& h, dsp::psola::Analyzer<SampleType>& analyzerToUse)
-	: dsp::SynthVoiceBase<SampleType> (&h), shifter (analyzerToUse)
+HarmonizerVoice<SampleType>::HarmonizerVoice (Harmonizer<SampleType>& h, dsp::psola::Analyzer<SampleType>& analyzerToUse, int voiceIndex)
+	: dsp::SynthVoiceBase<SampleType> (&h), harmonizer (h), shifter (analyzerToUse), detune (voiceIndex)
 {
 }
 
@@ -12,8 +12,144 @@ void HarmonizerVoice<SampleType>::renderPlease (AudioBuffer& output, float desir
 {
 	jassert (desiredFrequency > 0 && currentSamplerate > 0);
 
-	shifter.setPitch (desiredFrequency, currentSamplerate);
-	shifter.getSamples (output);
+	// report once per render pass, in case the synth calls us several times within one sub-block
+	if (const auto pass = harmonizer.getRenderPass(); pass != lastRenderPass)
+	{
+		lastRenderPass	= pass;
+		isCulled		= ! harmonizer.reportVoicePriority (getPriority());
+		renderedSamples = 0;
+	}
+
+	const auto numSamples = output.getNumSamples();
+
+	// the synth renders each voice in order through the sub-block, from wherever the voice started, which is always
+	// the sub-block's first sample
+	const auto startSample = harmonizer.getSubBlockStart() + renderedSamples;
+	renderedSamples += numSamples;
+
+	if (isCulled && cullGain == SampleType (0))
+	{
+		// so that it picks up where the input is, rather than where it stopped, if it's allowed back
+		shifter.skipSamples (numSamples);
+		output.clear();
+		return;
+	}
+
+	const auto& voicing = harmonizer.voicing;
+
+	// during unvoiced frames there's no period to shift, so the input is heard as it is. Every sounding voice passes it
+	// through, so each only takes its share, and together they add up to the input heard once
+	crossfade.setTarget (voicing.shouldPassThrough());
+	crossfade.setDryGain (SampleType (1) / static_cast<SampleType> (harmonizer.getNumVoicesSounding()));
+
+	if (crossfade.needsSynthesis())
+		renderShifted (output, desiredFrequency, currentSamplerate, startSample);
+	else
+		shifter.skipSamples (numSamples);  // so that it picks up where the input is once it's voiced again
+
+	crossfade.process (output.getWritePointer (0), voicing.getFrame() + startSample, numSamples);
+
+	writeChannels (output, numSamples);
+}
+
+template <typename SampleType>
+void HarmonizerVoice<SampleType>::renderShifted (AudioBuffer& output, float desiredFrequency, double currentSamplerate, int startSample)
+{
+	const auto numSamples = output.getNumSamples();
+
+	auto* samples = output.getWritePointer (0);
+
+	// pedal, descant, latch and played notes often land on the same pitch. The shifted signal is then identical, so
+	// it's rendered once and copied; each voice's own gain and pan are still applied after this returns. The key
+	// includes where in the frame the samples come from, so a voice only ever copies the same stretch of input
+	if (const auto* rendered = harmonizer.findRendering (desiredFrequency, startSample, numSamples))
+	{
+		juce::FloatVectorOperations::copy (samples, rendered, numSamples);
+
+		// kept in step with the input, so that it carries on from the right place once the pitches part
+		shifter.skipSamples (numSamples);
+	}
+	else
+	{
+		shifter.setPitch (desiredFrequency, currentSamplerate);
+		shifter.getSamples (output);
+
+		harmonizer.storeRendering (desiredFrequency, startSample, samples, numSamples);
+	}
+
+	detune.setEnabled (harmonizer.isUnisonDetuneEnabled());
+
+	if (! detune.isActive())
+		return;
+
+	if (detune.getSamplerate() != currentSamplerate)
+		detune.prepare (currentSamplerate);
+
+	detune.process (samples, numSamples);
+}
+
+template <typename SampleType>
+void HarmonizerVoice<SampleType>::writeChannels (AudioBuffer& output, int numSamples) noexcept
+{
+	const auto target = isCulled ? SampleType (0) : SampleType (1);
+
+	// the samples the cull fade still covers. Past them the gain is constant, so the rest of each channel is a plain
+	// copy or clear, which the compiler can vectorize
+	const auto numRamped = cullGain == target ? 0
+											  : std::min (numSamples, static_cast<int> (std::ceil (std::abs (target - cullGain) / cullFadeStep)));
+
+	const auto step = target > cullGain ? cullFadeStep : -cullFadeStep;
+
+	const auto* mono = output.getReadPointer (0);
+
+	// each channel is written straight from the mono signal with the voice's gain, in one pass, rather than scaling the
+	// signal in place and copying it out again. Channel 0 is the source, so it's written last
+	for (auto chan = output.getNumChannels() - 1; chan >= 0; --chan)
+	{
+		auto* dest = output.getWritePointer (chan);
+
+		for (auto i = 0; i < numRamped; ++i)
+			dest[i] = mono[i] * juce::jlimit (SampleType (0), SampleType (1), cullGain + step * static_cast<SampleType> (i + 1));
+
+		if (target == SampleType (0))
+			juce::FloatVectorOperations::clear (dest + numRamped, numSamples - numRamped);
+		else if (chan > 0)
+			juce::FloatVectorOperations::copy (dest + numRamped, mono + numRamped, numSamples - numRamped);
+	}
+
+	if (numRamped > 0)
+		cullGain = numRamped < numSamples ? target : juce::jlimit (SampleType (0), SampleType (1), cullGain + step * static_cast<SampleType> (numRamped));
+}
+
+template <typename SampleType>
+std::uint64_t HarmonizerVoice<SampleType>::getPriority()
+{
+	if (const auto note = this->getCurrentlyPlayingNote(); needsNoteStamp || note != lastNote)
+	{
+		noteStamp	   = harmonizer.getNextNoteStamp();
+		lastNote	   = note;
+		needsNoteStamp = false;
+		isReleased	   = false;
+	}
+
+	constexpr auto heldBit = std::uint64_t (1) << 63;
+
+	return isReleased ? noteStamp : noteStamp | heldBit;
+}
+
+template <typename SampleType>
+void HarmonizerVoice<SampleType>::released()
+{
+	isReleased = true;
+}
+
+template <typename SampleType>
+void HarmonizerVoice<SampleType>::noteCleared()
+{
+	// the next note this voice plays starts at full level, and gets a fresh stamp
+	needsNoteStamp = true;
+	isCulled	   = false;
+	cullGain	   = SampleType (1);
 }
 
 template class HarmonizerVoice<float>;
@@ -17,13 +17,47 @@ class HarmonizerVoice : public dsp::SynthVoiceBase<SampleType>
 
 public:
 
-	HarmonizerVoice (Harmonizer<SampleType>& h, dsp::psola::Analyzer<SampleType>& analyzerToUse);
+	HarmonizerVoice (Harmonizer<SampleType>& h, dsp::psola::Analyzer<SampleType>& analyzerToUse, int voiceIndex);
 
 private:
 
 	void renderPlease (AudioBuffer& output, float desiredFrequency, double currentSamplerate) final;
 
+	void renderShifted (AudioBuffer& output, float desiredFrequency, double currentSamplerate, int startSample);
+
+	void released() final;
+	void noteCleared() final;
+
+	// held notes outrank released ones, and newer notes outrank older ones
+	std::uint64_t getPriority();
+
+	// applies the cull fade to the mono signal in channel 0, and writes it into every channel of the output
+	void writeChannels (AudioBuffer& output, int numSamples) noexcept;
+
+	// the same length as the unvoiced crossfade
+	static constexpr auto cullFadeStep = SampleType (1) / SampleType (256);
+
+	Harmonizer<SampleType>& harmonizer;
+
 	dsp::psola::Shifter<SampleType> shifter;
+
+	UnvoicedCrossfade<SampleType> crossfade;
+
+	MicroDetune<SampleType> detune;
+
+	std::uint32_t lastRenderPass { 0 };
+
+	std::uint64_t noteStamp { 0 };
+	int			  lastNote { -1 };
+	bool		  needsNoteStamp { true };
+	bool		  isReleased { false };
+
+	// when the harmonizer culls this voice it fades out, and then only keeps its shifter in step with the input
+	bool	   isCulled { false };
+	SampleType cullGain { 1 };
+
+	// how far into the current sub-block this voice has rendered
+	int renderedSamples { 0 };
 };
 
 
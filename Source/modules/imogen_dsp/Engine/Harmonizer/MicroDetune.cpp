@@ -0,0 +1,84 @@
+namespace Imogen
+{
+template <typename SampleType>
+MicroDetune<SampleType>::MicroDetune (int voiceIndex)
+	: rateHz (0.35 + 0.11 * (voiceIndex % 7)),
+	  startPhase (juce::MathConstants<double>::twoPi * std::fmod (voiceIndex * 0.618033988749895, 1.))
+{
+	reset();
+}
+
+template <typename SampleType>
+void MicroDetune<SampleType>::prepare (double newSamplerate)
+{
+	jassert (newSamplerate > 0.);
+
+	samplerate = newSamplerate;
+
+	phaseIncrement = juce::MathConstants<double>::twoPi * rateHz / samplerate;
+
+	// the pitch ratio follows the rate of change of the delay, which peaks at depth * phaseIncrement
+	depth  = std::min ((std::pow (2., maxCents / 1200.) - 1.) / phaseIncrement, (bufferSize - 4) * 0.5);
+	centre = depth + 1.;
+
+	// the ramp shifts the pitch by no more than the modulation itself does
+	depthScaleStep = (std::pow (2., maxCents / 1200.) - 1.) / centre;
+
+	reset();
+}
+
+template <typename SampleType>
+void MicroDetune<SampleType>::reset()
+{
+	buffer.fill (SampleType (0));
+	writePosition = 0;
+	phase		  = startPhase;
+	depthScale	  = 0.;
+}
+
+template <typename SampleType>
+void MicroDetune<SampleType>::setEnabled (bool shouldBeEnabled) noexcept
+{
+	// the delay ramps up from 0, so it only ever reads what's been written since this
+	if (shouldBeEnabled && ! isActive())
+		reset();
+
+	enabled = shouldBeEnabled;
+}
+
+template <typename SampleType>
+void MicroDetune<SampleType>::process (SampleType* samples, int numSamples) noexcept
+{
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		buffer[static_cast<size_t> (writePosition)] = samples[i];
+
+		if (enabled)
+			depthScale = std::min (1., depthScale + depthScaleStep);
+		else
+			depthScale = std::max (0., depthScale - depthScaleStep);
+
+		const auto delay = depthScale * (centre + depth * std::sin (phase));
+
+		phase += phaseIncrement;
+
+		if (phase >= juce::MathConstants<double>::twoPi)
+			phase -= juce::MathConstants<double>::twoPi;
+
+		const auto readPosition = static_cast<double> (writePosition) - delay;
+		const auto whole		= static_cast<int> (std::floor (readPosition));
+		const auto fraction		= static_cast<SampleType> (readPosition - whole);
+
+		const auto a = buffer[static_cast<size_t> (whole & bufferMask)];
+		const auto b = buffer[static_cast<size_t> ((whole + 1) & bufferMask)];
+
+		samples[i] = a + fraction * (b - a);
+
+		writePosition = (writePosition + 1) & bufferMask;
+	}
+}
+
+template class MicroDetune<float>;
+template class MicroDetune<double>;
+
+}  // namespace Imogen
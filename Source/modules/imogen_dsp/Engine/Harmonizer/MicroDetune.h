@@ -0,0 +1,58 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	A slowly modulated short delay, which drifts the pitch of a voice a few cents either side of its target.
+	Voices that share a pitch are rendered once and copied, so without this they'd be perfectly phase-locked.
+*/
+template <typename SampleType>
+class MicroDetune
+{
+public:
+
+	// voices with different indices drift at different rates, and start at different points in their cycle
+	explicit MicroDetune (int voiceIndex);
+
+	void prepare (double samplerate);
+
+	void reset();
+
+	// switching on starts from no delay, and switching off returns to it, each ramped slowly enough not to be heard
+	void setEnabled (bool shouldBeEnabled) noexcept;
+
+	// false once it's been switched off and has ramped all the way back, when there's no need to process anything
+	bool isActive() const noexcept { return enabled || depthScale > 0.; }
+
+	void process (SampleType* samples, int numSamples) noexcept;
+
+	double getSamplerate() const noexcept { return samplerate; }
+
+private:
+
+	static constexpr auto maxCents = 4.;
+
+	static constexpr auto bufferSize = 512;
+	static constexpr auto bufferMask = bufferSize - 1;
+
+	const double rateHz;
+	const double startPhase;
+
+	double samplerate { 0. };
+
+	double phase { 0. }, phaseIncrement { 0. };
+
+	// the modulated delay swings by depth either side of centre
+	double depth { 0. }, centre { 0. };
+
+	// scales the whole delay, from 0 when off to 1 when on
+	double depthScale { 0. }, depthScaleStep { 0. };
+
+	bool enabled { false };
+
+	std::array<SampleType, bufferSize> buffer;
+
+	int writePosition { 0 };
+};
+
+}  // namespace Imogen
@@ -0,0 +1,105 @@
+namespace Imogen
+{
+template <typename SampleType>
+DryMonitor<SampleType>::DryMonitor (State& stateToUse)
+	: parameters (stateToUse.parameters), internals (stateToUse.internals)
+{
+}
+
+template <typename SampleType>
+void DryMonitor<SampleType>::prepare (double samplerate, int blocksize)
+{
+	monoBuffer.setSize (1, blocksize, false, false, true);
+	pannedBuffer.setSize (2, blocksize, false, false, true);
+
+	dryPanner.prepare (samplerate, blocksize);
+
+	numCaptured = 0;
+	lastLevel	= 0;
+}
+
+template <typename SampleType>
+bool DryMonitor<SampleType>::isEnabled() const
+{
+	return parameters.engineState.dryMonitoring->get() && ! parameters.leadBypass->get();
+}
+
+template <typename SampleType>
+SampleType DryMonitor<SampleType>::getLevel() const
+{
+	// the same balance against the harmonies, and the same output gain, that the engine would have given the lead
+	const auto dryMix = SampleType (1) - static_cast<SampleType> (parameters.dryWet->get()) * SampleType (0.01);
+
+	return dryMix * juce::Decibels::decibelsToGain (static_cast<SampleType> (parameters.outputGain->get()));
+}
+
+template <typename SampleType>
+void DryMonitor<SampleType>::capture (const AudioBuffer& input, bool hostIsPlaying)
+{
+	const auto isMonitoring = isEnabled() && ! hostIsPlaying && input.getNumChannels() > 0;
+
+	internals.isMonitoringDry.store (isMonitoring, std::memory_order_relaxed);
+
+	if (! isMonitoring)
+	{
+		// fades back in from silence when it's next turned on
+		numCaptured = 0;
+		lastLevel	= 0;
+		return;
+	}
+
+	// a host that sends more than it prepared for only gets the start of the block monitored
+	numCaptured = std::min (input.getNumSamples(), monoBuffer.getNumSamples());
+
+	inputAlias.setDataToReferTo (const_cast<SampleType**> (input.getArrayOfReadPointers()), input.getNumChannels(), numCaptured);
+
+	monoAlias.setDataToReferTo (monoBuffer.getArrayOfWritePointers(), 1, numCaptured);
+
+	stereoReducer.process (inputAlias, monoAlias);
+}
+
+template <typename SampleType>
+void DryMonitor<SampleType>::addTo (AudioBuffer& output)
+{
+	if (numCaptured == 0 || output.getNumChannels() < 2)
+		return;
+
+	pannedAlias.setDataToReferTo (pannedBuffer.getArrayOfWritePointers(), 2, numCaptured);
+
+	dryPanner.process (monoAlias, pannedAlias, false);
+
+	const auto level = getLevel();
+
+	for (auto channel = 0; channel < 2; ++channel)
+		output.addFromWithRamp (channel, 0, pannedAlias.getReadPointer (channel), numCaptured, lastLevel, level);
+
+	lastLevel = level;
+
+	// the limiter has already run, and its lookahead is the delay this path exists to avoid. A soft clip keeps the sum
+	// under the ceiling without adding latency, and leaves everything below the knee untouched
+	if (! parameters.limiterToggle->get())
+		return;
+
+	for (auto channel = 0; channel < 2; ++channel)
+	{
+		auto* samples = output.getWritePointer (channel);
+
+		for (auto i = 0; i < numCaptured; ++i)
+		{
+			const auto magnitude = std::abs (samples[i]);
+
+			if (magnitude <= knee)
+				continue;
+
+			// tanh has a slope of 1 at 0, so the curve joins the straight part without a kink
+			const auto clipped = knee + (ceiling - knee) * std::tanh ((magnitude - knee) / (ceiling - knee));
+
+			samples[i] = samples[i] < 0 ? -clipped : clipped;
+		}
+	}
+}
+
+template class DryMonitor<float>;
+template class DryMonitor<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "DryPanner.h"
+
+namespace Imogen
+{
+/*
+	Zero-latency monitoring for the lead. The processor hands over the main input before the engine sees it, and this
+	pans it and mixes it into the engine's output afterwards, so the singer hears themself without the analysis delay.
+	The engine mutes its own lead meanwhile, so only the harmonies are delayed. The monitored lead isn't pitch corrected,
+	and skips the whole post-harmony chain: EQ, compressor, de-esser, delay, reverb and limiter. While the limiter is
+	on, the sum is soft clipped towards its ceiling.
+	The host can't compensate for a path with no delay, so against recorded tracks the monitored lead would be early.
+	It's only used while the transport is stopped; during playback the engine renders the lead itself, lined up.
+*/
+template <typename SampleType>
+class DryMonitor
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	DryMonitor (State& stateToUse);
+
+	void prepare (double samplerate, int blocksize);
+
+	// takes a mono copy of the input, before the engine overwrites it. Does nothing unless monitoring is on and the
+	// host is stopped, and tells the engine whether to leave its own lead out
+	void capture (const AudioBuffer& input, bool hostIsPlaying);
+
+	void addTo (AudioBuffer& output);
+
+private:
+
+	bool isEnabled() const;
+
+	SampleType getLevel() const;
+
+	Parameters& parameters;
+	Internals&	internals;
+
+	StereoReducer<SampleType> stereoReducer { parameters };
+	DryPanner<SampleType>	  dryPanner { parameters };
+
+	AudioBuffer monoBuffer, pannedBuffer;
+	AudioBuffer inputAlias, monoAlias, pannedAlias;
+
+	int numCaptured { 0 };
+
+	// the level the last block ended on, so that changes are ramped
+	SampleType lastLevel { 0 };
+
+	// the limiter's threshold is 0 dBFS. Above the knee, the sum is bent smoothly towards it instead of being cut off
+	static constexpr auto ceiling = SampleType (1);
+	static constexpr auto knee	  = SampleType (0.8);
+};
+
+}  // namespace Imogen
@@ -10,12 +10,20 @@ LeadProcessor<SampleType>::LeadProcessor (Harmonizer<SampleType>& harm, State& s
 template <typename SampleType>
 void LeadProcessor<SampleType>::prepare (double samplerate, int blocksize)
 {
-	pannedLeadBuffer.setSize (2, blocksize, true, true, true);
-
 	dryPanner.prepare (samplerate, blocksize);
 	pitchCorrector.prepare (samplerate, blocksize);
 }
 
+template <typename SampleType>
+void LeadProcessor<SampleType>::requestBuffers (BufferArena<SampleType>& arena)
+{
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	arena.request (pannedLeadBuffer, 2, Stage::lead, Stage::postHarmony);
+
+	pitchCorrector.requestBuffers (arena);
+}
+
 template <typename SampleType>
 void LeadProcessor<SampleType>::process (bool leadIsBypassed, int numSamples)
 {
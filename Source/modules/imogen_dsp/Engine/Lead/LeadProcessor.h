@@ -23,6 +23,8 @@ public:
 
 	AudioBuffer& getProcessedSignal();
 
+	void requestBuffers (BufferArena<SampleType>& arena);
+
 private:
 
 	PitchCorrection<SampleType> pitchCorrector;
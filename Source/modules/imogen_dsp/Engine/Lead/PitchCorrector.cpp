@@ -3,7 +3,7 @@ namespace Imogen
 {
 template <typename SampleType>
 PitchCorrection<SampleType>::PitchCorrection (Harmonizer<SampleType>& harm, Internals& internalsToUse)
-	: Base (harm.analyzer, harm.getPitchAdjuster()), internals (internalsToUse)
+	: Base (harm.analyzer, harm.getPitchAdjuster()), internals (internalsToUse), harmonizer (harm), voicing (harm.voicing)
 {
 }
 
@@ -12,10 +12,21 @@ void PitchCorrection<SampleType>::renderNextFrame (int numSamples)
 {
 	alias.setDataToReferTo (correctedBuffer.getArrayOfWritePointers(), 1, numSamples);
 
-	this->processNextFrame (alias);
+	crossfade.setTarget (voicing.shouldPassThrough());
 
-	internals.currentInputNote->set (this->getOutputMidiPitch());
-	internals.currentCentsSharp->set (this->getCentsSharp());
+	// unvoiced frames have no pitch to correct, so they're passed through instead
+	if (crossfade.needsSynthesis())
+	{
+		this->processNextFrame (alias);
+
+		if (harmonizer.isPublishingInternals())
+		{
+			internals.currentInputNote->set (this->getOutputMidiPitch());
+			internals.currentCentsSharp->set (this->getCentsSharp());
+		}
+	}
+
+	crossfade.process (alias.getWritePointer (0), voicing.getFrame(), numSamples);
 }
 
 template <typename SampleType>
@@ -25,10 +36,18 @@ const juce::AudioBuffer<SampleType>& PitchCorrection<SampleType>::getCorrectedSi
 }
 
 template <typename SampleType>
-void PitchCorrection<SampleType>::prepare (double samplerate, int blocksize)
+void PitchCorrection<SampleType>::prepare (double samplerate, int)
 {
-	correctedBuffer.setSize (1, blocksize, true, true, true);
 	Base::prepare (samplerate);
+	crossfade.reset();
+}
+
+template <typename SampleType>
+void PitchCorrection<SampleType>::requestBuffers (BufferArena<SampleType>& arena)
+{
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	arena.request (correctedBuffer, 1, Stage::lead, Stage::lead);
 }
 
 template class PitchCorrection<float>;
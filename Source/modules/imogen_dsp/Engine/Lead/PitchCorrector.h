@@ -1,6 +1,7 @@
 #pragma once
 
 #include <imogen_dsp/Engine/Harmonizer/Harmonizer.h>
+#include <imogen_dsp/Engine/BufferArena.h>
 
 namespace Imogen
 {
@@ -20,10 +21,16 @@ public:
 
 	const AudioBuffer& getCorrectedSignal() const;
 
+	void requestBuffers (BufferArena<SampleType>& arena);
+
 private:
 
 	Internals& internals;
 
+	Harmonizer<SampleType>&		  harmonizer;
+	VoicingDetector<SampleType>&  voicing;
+	UnvoicedCrossfade<SampleType> crossfade;
+
 	AudioBuffer correctedBuffer;
 	AudioBuffer alias;
 };
@@ -0,0 +1,68 @@
+
+namespace Imogen
+{
+void LoadGovernor::prepare (double newSamplerate)
+{
+	samplerate = newSamplerate;
+	reset();
+}
+
+void LoadGovernor::reset()
+{
+	smoothedLoad		= 0.;
+	numOverloadedBlocks = 0;
+	numLightBlocks		= 0;
+	tier				= Tier::full;
+}
+
+bool LoadGovernor::blockRendered (int budgetSamples, double secondsTaken)
+{
+	if (budgetSamples <= 0 || samplerate <= 0.)
+		return false;
+
+	const auto deadline = static_cast<double> (budgetSamples) / samplerate;
+
+	smoothedLoad += (secondsTaken / deadline - smoothedLoad) * smoothingCoeff;
+
+	if (smoothedLoad > overloadThreshold)
+	{
+		numLightBlocks = 0;
+
+		if (++numOverloadedBlocks >= overloadHoldBlocks && tier != Tier::minimal)
+		{
+			changeTier (1);
+			return true;
+		}
+
+		return false;
+	}
+
+	numOverloadedBlocks = 0;
+
+	if (smoothedLoad < restoreThreshold)
+	{
+		if (++numLightBlocks >= restoreHoldBlocks && tier != Tier::full)
+		{
+			changeTier (-1);
+			return true;
+		}
+	}
+	else
+	{
+		numLightBlocks = 0;
+	}
+
+	return false;
+}
+
+void LoadGovernor::changeTier (int direction)
+{
+	tier = static_cast<Tier> (static_cast<int> (tier) + direction);
+
+	// start measuring again from scratch, so the new tier gets a chance to take effect before we judge it
+	smoothedLoad		= 0.;
+	numOverloadedBlocks = 0;
+	numLightBlocks		= 0;
+}
+
+}  // namespace Imogen
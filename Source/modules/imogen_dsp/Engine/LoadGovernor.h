@@ -0,0 +1,52 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	Compares the time spent rendering each block with the time available for it, and steps down to cheaper
+	quality tiers when the engine keeps getting close to its deadline.
+	Stepping back up needs a much longer run of light blocks, so the tier doesn't flap back and forth.
+*/
+class LoadGovernor
+{
+public:
+
+	enum class Tier
+	{
+		full	= 0,
+		reduced = 1,
+		minimal = 2
+	};
+
+	void prepare (double samplerate);
+
+	void reset();
+
+	// budgetSamples is how long, at the session rate, the block had to be rendered in. Returns true if the tier changed
+	bool blockRendered (int budgetSamples, double secondsTaken);
+
+	Tier getTier() const noexcept { return tier; }
+
+private:
+
+	void changeTier (int direction);
+
+	static constexpr auto smoothingCoeff = 0.1;
+
+	static constexpr auto overloadThreshold = 0.8;
+	static constexpr auto restoreThreshold	= 0.45;
+
+	static constexpr auto overloadHoldBlocks = 4;
+	static constexpr auto restoreHoldBlocks	 = 250;
+
+	double samplerate { 0. };
+
+	double smoothedLoad { 0. };
+
+	int numOverloadedBlocks { 0 };
+	int numLightBlocks { 0 };
+
+	Tier tier { Tier::full };
+};
+
+}  // namespace Imogen
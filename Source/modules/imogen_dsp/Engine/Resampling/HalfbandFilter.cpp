@@ -0,0 +1,119 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+HalfbandFilter<SampleType>::HalfbandFilter()
+{
+	// Blackman-windowed sinc. Every even-indexed tap falls on an odd distance from the centre tap,
+	// so these are the only non-zero coefficients apart from the centre tap itself, which is 0.5
+
+	constexpr auto centre = static_cast<double> (latencySamples);
+	constexpr auto pi	  = juce::MathConstants<double>::pi;
+
+	auto sum = 0.;
+
+	for (auto i = 0; i < numSideTaps; ++i)
+	{
+		const auto n = static_cast<double> (i * 2);
+		const auto k = n - centre;
+
+		const auto sinc	  = std::sin (pi * k * 0.5) / (pi * k);
+		const auto window = 0.42 - 0.5 * std::cos (2. * pi * n / (numTaps - 1)) + 0.08 * std::cos (4. * pi * n / (numTaps - 1));
+
+		sideTaps[static_cast<size_t> (i)] = static_cast<SampleType> (sinc * window);
+		sum += sinc * window;
+	}
+
+	// normalize for unity gain at DC
+	for (auto& tap : sideTaps)
+		tap = static_cast<SampleType> (static_cast<double> (tap) * 0.5 / sum);
+}
+
+template <typename SampleType>
+void HalfbandFilter<SampleType>::prepare (int numChannels)
+{
+	// these histories are stored twice over, so that the newest numSideTaps samples are always contiguous
+	upHistory.setSize (numChannels, numSideTaps * 2, false, false, true);
+	evenHistory.setSize (numChannels, numSideTaps * 2, false, false, true);
+	oddHistory.setSize (numChannels, oddDelay, false, false, true);
+
+	upPositions.resize (static_cast<size_t> (numChannels));
+	evenPositions.resize (static_cast<size_t> (numChannels));
+	oddPositions.resize (static_cast<size_t> (numChannels));
+
+	reset();
+}
+
+template <typename SampleType>
+void HalfbandFilter<SampleType>::reset()
+{
+	upHistory.clear();
+	evenHistory.clear();
+	oddHistory.clear();
+
+	std::fill (upPositions.begin(), upPositions.end(), 0);
+	std::fill (evenPositions.begin(), evenPositions.end(), 0);
+	std::fill (oddPositions.begin(), oddPositions.end(), 0);
+}
+
+template <typename SampleType>
+void HalfbandFilter<SampleType>::upsample (int channel, const SampleType* input, SampleType* output, int numSamples)
+{
+	auto* history = upHistory.getWritePointer (channel);
+	auto& pos	  = upPositions[static_cast<size_t> (channel)];
+
+	for (auto s = 0; s < numSamples; ++s)
+	{
+		pos = (pos + numSideTaps - 1) % numSideTaps;
+
+		history[pos]			   = input[s];
+		history[pos + numSideTaps] = input[s];
+
+		const auto* newest = history + pos;
+
+		auto even = SampleType (0);
+
+		for (auto i = 0; i < numSideTaps; ++i)
+			even += sideTaps[static_cast<size_t> (i)] * newest[i];
+
+		// the zero-stuffed signal loses half its energy, hence the gain of 2 on both phases
+		output[s * 2]	  = even * SampleType (2);
+		output[s * 2 + 1] = newest[centreOffset];
+	}
+}
+
+template <typename SampleType>
+void HalfbandFilter<SampleType>::downsample (int channel, const SampleType* input, SampleType* output, int numSamples)
+{
+	auto* evens = evenHistory.getWritePointer (channel);
+	auto* odds	= oddHistory.getWritePointer (channel);
+
+	auto& evenPos = evenPositions[static_cast<size_t> (channel)];
+	auto& oddPos  = oddPositions[static_cast<size_t> (channel)];
+
+	for (auto s = 0; s < numSamples; ++s)
+	{
+		evenPos = (evenPos + numSideTaps - 1) % numSideTaps;
+
+		evens[evenPos]				 = input[s * 2];
+		evens[evenPos + numSideTaps] = input[s * 2];
+
+		const auto* newestEven = evens + evenPos;
+
+		auto sum = SampleType (0);
+
+		for (auto i = 0; i < numSideTaps; ++i)
+			sum += sideTaps[static_cast<size_t> (i)] * newestEven[i];
+
+		// the odd sample from oddDelay pairs ago is the one that lines up with the centre tap
+		output[s] = sum + SampleType (0.5) * odds[oddPos];
+
+		odds[oddPos] = input[s * 2 + 1];
+		oddPos		 = (oddPos + 1) % oddDelay;
+	}
+}
+
+template class HalfbandFilter<float>;
+template class HalfbandFilter<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	A 2x polyphase halfband FIR, used as one stage of up- or downsampling.
+	Only the polyphase branches that have non-zero coefficients are computed.
+*/
+template <typename SampleType>
+class HalfbandFilter
+{
+public:
+
+	HalfbandFilter();
+
+	void prepare (int numChannels);
+
+	void reset();
+
+	// reads numSamples samples and writes numSamples * 2 samples
+	void upsample (int channel, const SampleType* input, SampleType* output, int numSamples);
+
+	// reads numSamples * 2 samples and writes numSamples samples
+	void downsample (int channel, const SampleType* input, SampleType* output, int numSamples);
+
+	static constexpr auto numTaps = 31;
+
+	// the group delay of one pass through the filter, in samples at the higher rate
+	static constexpr auto latencySamples = (numTaps - 1) / 2;
+
+private:
+
+	static constexpr auto numSideTaps  = (numTaps + 1) / 2;
+	static constexpr auto centreOffset = latencySamples / 2;
+	static constexpr auto oddDelay	   = centreOffset + 1;
+
+	std::array<SampleType, numSideTaps> sideTaps;
+
+	juce::AudioBuffer<SampleType> upHistory, evenHistory, oddHistory;
+
+	std::vector<int> upPositions, evenPositions, oddPositions;
+};
+
+}  // namespace Imogen
@@ -0,0 +1,168 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void HarmonyResampler<SampleType>::setNumStages (int newNumStages)
+{
+	jassert (newNumStages >= 0);
+	numStages = newNumStages;
+}
+
+template <typename SampleType>
+int HarmonyResampler<SampleType>::getNumStagesFor (double samplerate, double targetSamplerate)
+{
+	auto stages = 0;
+
+	while (samplerate * 0.5 >= targetSamplerate)
+	{
+		samplerate *= 0.5;
+		++stages;
+	}
+
+	return stages;
+}
+
+template <typename SampleType>
+int HarmonyResampler<SampleType>::getLatencySamples() const
+{
+	// each stage delays the signal once on the way down and once on the way up, at its own higher rate
+	auto latency = 0;
+
+	for (auto i = 0; i < numStages; ++i)
+		latency += HalfbandFilter<SampleType>::latencySamples * 2 * (1 << i);
+
+	return latency;
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::prepare (int blocksize)
+{
+	inputCascade.prepare (numStages, 1, blocksize);
+	harmonyCascade.prepare (numStages, 2, blocksize);
+	leadCascade.prepare (numStages, 2, blocksize);
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::reset()
+{
+	inputCascade.reset();
+	harmonyCascade.reset();
+	leadCascade.reset();
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::requestBuffers (BufferArena<SampleType>& arena)
+{
+	if (! isEnabled())
+		return;
+
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	// the shifters read the analyzed input while the harmony and lead are rendered
+	arena.request (inputStorage, 1, Stage::preHarmony, Stage::lead);
+	arena.request (harmonyStorage, 2, Stage::harmony, Stage::harmony);
+	arena.request (leadStorage, 2, Stage::lead, Stage::postHarmony);
+}
+
+template <typename SampleType>
+const SampleType* HarmonyResampler<SampleType>::downsampleInput (const SampleType* input, int numSamples)
+{
+	jassert (numSamples % getFactor() == 0);
+
+	lastNumSamples = numSamples;
+
+	auto* channels = const_cast<SampleType*> (input);
+	inputAlias.setDataToReferTo (&channels, 1, numSamples);
+
+	inputCascade.downsample (inputAlias, inputStorage, numSamples);
+
+	return inputStorage.getReadPointer (0);
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType>& HarmonyResampler<SampleType>::getHarmonyBuffer (int numSamples)
+{
+	harmonyAlias.setDataToReferTo (harmonyStorage.getArrayOfWritePointers(), 2, numSamples);
+	return harmonyAlias;
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::upsampleHarmony (AudioBuffer& output)
+{
+	jassert (output.getNumSamples() == lastNumSamples);
+
+	harmonyCascade.upsample (harmonyStorage, output, lastNumSamples / getFactor());
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType>& HarmonyResampler<SampleType>::upsampleLead (const AudioBuffer& lead)
+{
+	leadAlias.setDataToReferTo (leadStorage.getArrayOfWritePointers(), 2, lastNumSamples);
+
+	leadCascade.upsample (lead, leadAlias, lastNumSamples / getFactor());
+
+	return leadAlias;
+}
+
+/*-------------------------------------------------------------------------------------*/
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::Cascade::prepare (int numStages, int numChannels, int blocksize)
+{
+	const auto numIntermediates = std::max (0, numStages - 1);
+
+	filters.resize (static_cast<size_t> (numStages));
+	intermediates.resize (static_cast<size_t> (numIntermediates));
+
+	for (auto& filter : filters)
+		filter.prepare (numChannels);
+
+	// intermediates[i] holds the signal at 1 / 2^(i+1) of the session rate
+	for (auto i = 0; i < numIntermediates; ++i)
+		intermediates[static_cast<size_t> (i)].setSize (numChannels, blocksize >> (i + 1), false, false, true);
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::Cascade::reset()
+{
+	for (auto& filter : filters)
+		filter.reset();
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::Cascade::downsample (const AudioBuffer& input, AudioBuffer& output, int numSamples)
+{
+	const auto numStages = static_cast<int> (filters.size());
+
+	for (auto i = 0; i < numStages; ++i)
+	{
+		const auto& source = i == 0 ? input : intermediates[static_cast<size_t> (i - 1)];
+		auto&		dest   = i == numStages - 1 ? output : intermediates[static_cast<size_t> (i)];
+
+		for (auto chan = 0; chan < source.getNumChannels(); ++chan)
+			filters[static_cast<size_t> (i)].downsample (chan, source.getReadPointer (chan), dest.getWritePointer (chan), numSamples >> (i + 1));
+	}
+}
+
+template <typename SampleType>
+void HarmonyResampler<SampleType>::Cascade::upsample (const AudioBuffer& input, AudioBuffer& output, int numSamples)
+{
+	// the stages run from the lowest rate back up, so the last intermediate is the first one written
+	const auto numStages = static_cast<int> (filters.size());
+
+	for (auto i = 0; i < numStages; ++i)
+	{
+		const auto level = numStages - 1 - i;
+
+		const auto& source = i == 0 ? input : intermediates[static_cast<size_t> (level)];
+		auto&		dest   = level == 0 ? output : intermediates[static_cast<size_t> (level - 1)];
+
+		for (auto chan = 0; chan < dest.getNumChannels(); ++chan)
+			filters[static_cast<size_t> (i)].upsample (chan, source.getReadPointer (chan), dest.getWritePointer (chan), numSamples << i);
+	}
+}
+
+template class HarmonyResampler<float>;
+template class HarmonyResampler<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "HalfbandFilter.h"
+
+namespace Imogen
+{
+/*
+	Lets the harmony path run at a fraction of the session's samplerate.
+	The processed input is brought down by cascaded halfband stages before it's analyzed, and the rendered harmony
+	and lead are brought back up before the post-harmony effects. With no stages, the harmony path runs at the
+	session rate and nothing here is used.
+*/
+template <typename SampleType>
+class HarmonyResampler
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	// each stage halves the samplerate. Takes effect on the next prepare()
+	void setNumStages (int newNumStages);
+
+	// the most stages that keep the harmony path at or above targetSamplerate
+	static int getNumStagesFor (double samplerate, double targetSamplerate);
+
+	bool isEnabled() const noexcept { return numStages > 0; }
+
+	int getFactor() const noexcept { return 1 << numStages; }
+
+	// the delay of the whole round trip, in samples at the session rate
+	int getLatencySamples() const;
+
+	// blocksize is at the session rate
+	void prepare (int blocksize);
+
+	void reset();
+
+	void requestBuffers (BufferArena<SampleType>& arena);
+
+	// numSamples is at the session rate, and must be a multiple of getFactor()
+	const SampleType* downsampleInput (const SampleType* input, int numSamples);
+
+	// the buffer the harmony is rendered into, at the reduced rate
+	AudioBuffer& getHarmonyBuffer (int numSamples);
+
+	void upsampleHarmony (AudioBuffer& output);
+
+	// returns the lead brought back to the session rate, valid until the next block
+	AudioBuffer& upsampleLead (const AudioBuffer& lead);
+
+private:
+
+	struct Cascade
+	{
+		void prepare (int numStages, int numChannels, int blocksize);
+
+		void reset();
+
+		void downsample (const AudioBuffer& input, AudioBuffer& output, int numSamples);
+
+		void upsample (const AudioBuffer& input, AudioBuffer& output, int numSamples);
+
+		std::vector<HalfbandFilter<SampleType>> filters;
+
+		// the signal between each pair of stages
+		std::vector<AudioBuffer> intermediates;
+	};
+
+	Cascade inputCascade, harmonyCascade, leadCascade;
+
+	AudioBuffer inputStorage, harmonyStorage, leadStorage;
+	AudioBuffer inputAlias, harmonyAlias, leadAlias;
+
+	int numStages { 0 };
+
+	int lastNumSamples { 0 };
+};
+
+}  // namespace Imogen
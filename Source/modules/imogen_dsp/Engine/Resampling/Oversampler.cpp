@@ -0,0 +1,109 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void Oversampler<SampleType>::setNumStages (int newNumStages)
+{
+	jassert (newNumStages >= 0);
+	numStages = newNumStages;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::prepare (int numChannels, int blocksize)
+{
+	stages.resize (static_cast<size_t> (numStages));
+	stageBuffers.resize (static_cast<size_t> (numStages));
+
+	for (auto i = 0; i < numStages; ++i)
+	{
+		const auto idx = static_cast<size_t> (i);
+
+		stages[idx].prepare (numChannels);
+		stageBuffers[idx].setSize (numChannels, blocksize * (2 << i), true, true, true);
+	}
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::reset()
+{
+	for (auto& stage : stages)
+		stage.reset();
+}
+
+template <typename SampleType>
+juce::AudioBuffer<SampleType>& Oversampler<SampleType>::upsample (const AudioBuffer& input)
+{
+	lastNumSamples = input.getNumSamples();
+
+	const auto* source	   = &input;
+	auto		numSamples = lastNumSamples;
+
+	for (auto i = size_t (0); i < stages.size(); ++i)
+	{
+		auto& dest = stageBuffers[i];
+
+		for (auto chan = 0; chan < dest.getNumChannels(); ++chan)
+			stages[i].upsample (chan, source->getReadPointer (chan), dest.getWritePointer (chan), numSamples);
+
+		source = &dest;
+		numSamples *= 2;
+	}
+
+	alias.setDataToReferTo (const_cast<AudioBuffer*> (source)->getArrayOfWritePointers(), source->getNumChannels(), numSamples);
+	return alias;
+}
+
+template <typename SampleType>
+void Oversampler<SampleType>::downsample (AudioBuffer& output)
+{
+	jassert (output.getNumSamples() == lastNumSamples);
+
+	for (auto i = static_cast<int> (stages.size()) - 1; i >= 0; --i)
+	{
+		const auto idx		  = static_cast<size_t> (i);
+		const auto numSamples = lastNumSamples << i;
+
+		auto& source = stageBuffers[idx];
+		auto& dest	 = i > 0 ? stageBuffers[idx - 1] : output;
+
+		for (auto chan = 0; chan < dest.getNumChannels(); ++chan)
+			stages[idx].downsample (chan, source.getReadPointer (chan), dest.getWritePointer (chan), numSamples);
+	}
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getFactor() const
+{
+	return 1 << numStages;
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getOversampledLatency() const
+{
+	// each stage delays the signal twice (once on the way up and once on the way down), at its own rate
+	auto latency = 0;
+
+	for (auto i = 0; i < numStages; ++i)
+		latency += HalfbandFilter<SampleType>::latencySamples * 2 * (1 << (numStages - 1 - i));
+
+	return latency;
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getLatencySamples() const
+{
+	const auto factor = getFactor();
+
+	return (getOversampledLatency() + factor - 1) / factor;
+}
+
+template <typename SampleType>
+int Oversampler<SampleType>::getLatencyPaddingSamples() const
+{
+	return getLatencySamples() * getFactor() - getOversampledLatency();
+}
+
+template class Oversampler<float>;
+template class Oversampler<double>;
+
+}  // namespace Imogen
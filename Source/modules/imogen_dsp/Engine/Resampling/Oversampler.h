@@ -0,0 +1,56 @@
+#pragma once
+
+#include "HalfbandFilter.h"
+
+namespace Imogen
+{
+/*
+	Cascaded halfband stages that upsample a block, let you process it at the higher rate, and bring it back down.
+	All memory is allocated in prepare().
+*/
+template <typename SampleType>
+class Oversampler
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	// each stage doubles the samplerate. Takes effect on the next prepare()
+	void setNumStages (int newNumStages);
+
+	void prepare (int numChannels, int blocksize);
+
+	void reset();
+
+	// returns the oversampled signal, which is only valid until the next call to downsample()
+	AudioBuffer& upsample (const AudioBuffer& input);
+
+	void downsample (AudioBuffer& output);
+
+	int getFactor() const;
+
+	// rounded up to a whole number of samples at the original rate
+	int getLatencySamples() const;
+
+	// the extra delay, in samples at the oversampled rate, that whatever runs between upsample() and downsample() should
+	// add so that the total latency is exactly getLatencySamples()
+	int getLatencyPaddingSamples() const;
+
+private:
+
+	// the exact latency, in samples at the oversampled rate
+	int getOversampledLatency() const;
+
+	std::vector<HalfbandFilter<SampleType>> stages;
+
+	// stageBuffers[i] holds the signal at 2^(i+1) times the original rate
+	std::vector<AudioBuffer> stageBuffers;
+
+	AudioBuffer alias;
+
+	int numStages { 0 };
+
+	int lastNumSamples { 0 };
+};
+
+}  // namespace Imogen
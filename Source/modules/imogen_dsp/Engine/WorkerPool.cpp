@@ -0,0 +1,135 @@
+namespace Imogen
+{
+WorkerPool::~WorkerPool()
+{
+	stop();
+}
+
+void WorkerPool::start (int numWorkers, Job&& jobToRun)
+{
+	jassert (numWorkers >= 0);
+
+	stop();
+
+	job = std::move (jobToRun);
+
+	for (auto i = 1; i <= numWorkers; ++i)
+	{
+		auto& worker = *workers.emplace_back (std::make_unique<Worker> (*this, i));
+
+		worker.startThread (juce::Thread::realtimeAudioPriority);
+	}
+}
+
+void WorkerPool::stop()
+{
+	for (auto& worker : workers)
+	{
+		worker->signalThreadShouldExit();
+		worker->workAvailable.signal();
+	}
+
+	for (auto& worker : workers)
+		worker->stopThread (maxWaitMs * 10);
+
+	workers.clear();
+}
+
+WorkerPool::JobMask WorkerPool::run (int numJobs, juce::int64 deadlineTicks)
+{
+	jassert (numJobs > 0 && numJobs <= getNumWorkers() + 1 && numJobs <= maxJobs);
+
+	JobMask dispatched = 0;
+
+	for (auto i = 1; i < numJobs; ++i)
+	{
+		auto& worker = getWorker (i);
+
+		auto expected = JobState::idle;
+
+		if (worker.state.compare_exchange_strong (expected, JobState::queued, std::memory_order_acq_rel))
+		{
+			dispatched |= JobMask (1) << i;
+			worker.workAvailable.signal();
+		}
+	}
+
+	job (0);
+
+	JobMask finished = 1;
+
+	// a worker that hasn't woken up yet would only start late, so its job is run here instead
+	for (auto i = 1; i < numJobs; ++i)
+	{
+		if ((dispatched & (JobMask (1) << i)) == 0)
+			continue;
+
+		auto& worker = getWorker (i);
+
+		auto expected = JobState::queued;
+
+		if (worker.state.compare_exchange_strong (expected, JobState::running, std::memory_order_acq_rel))
+		{
+			job (i);
+			worker.state.store (JobState::idle, std::memory_order_release);
+			finished |= JobMask (1) << i;
+		}
+	}
+
+	// the rest usually finish about when job 0 does, so this spins briefly, and then yields rather than sleeping on a lock
+	for (auto spins = 0; (finished & dispatched) != dispatched; ++spins)
+	{
+		for (auto i = 1; i < numJobs; ++i)
+			if ((dispatched & (JobMask (1) << i)) != 0 && ! isBusy (i))
+				finished |= JobMask (1) << i;
+
+		if ((finished & dispatched) == dispatched || juce::Time::getHighResolutionTicks() >= deadlineTicks)
+			break;
+
+		if (spins >= maxSpins)
+			juce::Thread::yield();
+	}
+
+	return finished;
+}
+
+bool WorkerPool::isBusy (int jobIndex) const noexcept
+{
+	if (jobIndex < 1 || jobIndex > getNumWorkers())
+		return false;
+
+	return getWorker (jobIndex).state.load (std::memory_order_acquire) != JobState::idle;
+}
+
+void WorkerPool::waitUntilIdle() const
+{
+	for (auto i = 1; i <= getNumWorkers(); ++i)
+		while (isBusy (i))
+			juce::Thread::sleep (1);
+}
+
+WorkerPool::Worker::Worker (WorkerPool& poolToUse, int jobIndexToRun)
+	: juce::Thread ("Imogen worker " + juce::String (jobIndexToRun)), pool (poolToUse), jobIndex (jobIndexToRun)
+{
+}
+
+void WorkerPool::Worker::run()
+{
+	while (! threadShouldExit())
+	{
+		if (! workAvailable.wait (maxWaitMs) || threadShouldExit())
+			continue;
+
+		auto expected = JobState::queued;
+
+		// the calling thread ran it itself
+		if (! state.compare_exchange_strong (expected, JobState::running, std::memory_order_acq_rel))
+			continue;
+
+		pool.job (jobIndex);
+
+		state.store (JobState::idle, std::memory_order_release);
+	}
+}
+
+}  // namespace Imogen
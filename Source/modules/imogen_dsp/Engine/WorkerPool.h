@@ -0,0 +1,78 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	A fixed set of realtime-priority threads that run one block's worth of jobs in parallel, at the audio thread's request.
+	The calling thread runs job 0 itself, so running N jobs needs N - 1 workers. A job that a worker hasn't started by
+	the time job 0 is done is run by the calling thread instead, and a job still running at the deadline is left to
+	finish on its own, without holding up the audio thread.
+*/
+class WorkerPool
+{
+public:
+
+	using Job = std::function<void (int jobIndex)>;
+
+	// bit N is set for job N
+	using JobMask = std::uint32_t;
+
+	static constexpr auto maxJobs = 32;
+
+	~WorkerPool();
+
+	// starts the workers, replacing any that were running. Not realtime safe
+	void start (int numWorkers, Job&& jobToRun);
+
+	void stop();
+
+	int getNumWorkers() const noexcept { return static_cast<int> (workers.size()); }
+
+	// runs the job for every index below numJobs whose worker isn't still busy with a job from an earlier call, and
+	// returns the jobs that finished by deadlineTicks. The rest carry on, and whatever they produce should be ignored
+	JobMask run (int numJobs, juce::int64 deadlineTicks);
+
+	// true while a job that missed its deadline is still running
+	bool isBusy (int jobIndex) const noexcept;
+
+	// blocks until no job is running. Not realtime safe
+	void waitUntilIdle() const;
+
+private:
+
+	enum class JobState
+	{
+		idle,
+		queued,
+		running
+	};
+
+	class Worker : public juce::Thread
+	{
+	public:
+
+		Worker (WorkerPool& poolToUse, int jobIndexToRun);
+
+		juce::WaitableEvent workAvailable;
+
+		std::atomic<JobState> state { JobState::idle };
+
+	private:
+
+		void run() final;
+
+		WorkerPool& pool;
+		const int	jobIndex;
+	};
+
+	Worker& getWorker (int jobIndex) const noexcept { return *workers[static_cast<size_t> (jobIndex - 1)]; }
+
+	Job job;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	static constexpr auto maxWaitMs = 100;
+	static constexpr auto maxSpins	= 1000;
+};
+
+}  // namespace Imogen
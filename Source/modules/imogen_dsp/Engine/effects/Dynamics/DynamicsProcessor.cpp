@@ -0,0 +1,83 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void DynamicsProcessor<SampleType>::prepare (double samplerate, int blocksize)
+{
+	envelopeFollower.prepare (samplerate);
+
+	// only ever grows, so a later prepare with a smaller blocksize doesn't reallocate
+	if (static_cast<int> (gains.size()) < blocksize)
+		gains.resize (static_cast<size_t> (blocksize));
+
+	averageGainReduction = 0;
+}
+
+template <typename SampleType>
+void DynamicsProcessor<SampleType>::reset()
+{
+	envelopeFollower.reset();
+	averageGainReduction = 0;
+}
+
+template <typename SampleType>
+void DynamicsProcessor<SampleType>::process (AudioBuffer& audio)
+{
+	process (audio, audio);
+}
+
+template <typename SampleType>
+void DynamicsProcessor<SampleType>::process (const AudioBuffer& sidechain, AudioBuffer& audio)
+{
+	const auto numSamples = audio.getNumSamples();
+
+	if (numSamples == 0)
+		return;
+
+	jassert (numSamples <= static_cast<int> (gains.size()));
+
+	auto* g = gains.data();
+
+	envelopeFollower.process (sidechain, g, numSamples);
+
+	DynamicsMath::gainToDecibels (g, g, numSamples);
+
+	gainComputer.process (g, g, numSamples);
+
+	auto total = SampleType (0);
+
+	for (auto i = 0; i < numSamples; ++i)
+		total += g[i];
+
+	averageGainReduction = total / static_cast<SampleType> (numSamples);
+
+	DynamicsMath::decibelsToGain (g, g, numSamples);
+
+	for (auto chan = 0; chan < audio.getNumChannels(); ++chan)
+		juce::FloatVectorOperations::multiply (audio.getWritePointer (chan), g, numSamples);
+}
+
+template <typename SampleType>
+SampleType DynamicsProcessor<SampleType>::processSample (SampleType sidechainPeak) noexcept
+{
+	// exactly the steps process() takes for each sample, so the two give identical results
+	const auto envelope = envelopeFollower.processSample (sidechainPeak);
+	const auto levelDb	= DynamicsMath::gainToDecibels (envelope);
+	const auto gainDb	= gainComputer.getGainDb (levelDb);
+
+	gainReductionTotal += gainDb;
+
+	return DynamicsMath::decibelsToGain (gainDb);
+}
+
+template <typename SampleType>
+void DynamicsProcessor<SampleType>::finishBlock (int numSamples) noexcept
+{
+	if (numSamples > 0)
+		averageGainReduction = gainReductionTotal / static_cast<SampleType> (numSamples);
+}
+
+template class DynamicsProcessor<float>;
+template class DynamicsProcessor<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "DynamicsMath.h"
+#include "EnvelopeFollower.h"
+#include "GainComputer.h"
+
+namespace Imogen
+{
+/*
+	The feed-forward core shared by the gate, compressor, de-esser and limiter:
+	envelope -> dB -> gain curve -> linear gain, a block at a time, applied to every channel of the signal.
+*/
+template <typename SampleType>
+class DynamicsProcessor
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+	using Type		  = typename GainComputer<SampleType>::Type;
+
+	void prepare (double samplerate, int blocksize);
+
+	void reset();
+
+	void setType (Type type) noexcept { gainComputer.setType (type); }
+	void setThreshold (SampleType thresholdDb) noexcept { gainComputer.setThreshold (thresholdDb); }
+	void setRatio (SampleType ratio) noexcept { gainComputer.setRatio (ratio); }
+	void setKnee (SampleType kneeWidthDb) noexcept { gainComputer.setKnee (kneeWidthDb); }
+	void setRange (SampleType maxReductionDb) noexcept { gainComputer.setRange (maxReductionDb); }
+
+	void setAttackMs (float attackMs) { envelopeFollower.setAttackMs (attackMs); }
+	void setReleaseMs (float releaseMs) { envelopeFollower.setReleaseMs (releaseMs); }
+
+	void process (AudioBuffer& audio);
+
+	// the gain is computed from sidechain, and applied to audio
+	void process (const AudioBuffer& sidechain, AudioBuffer& audio);
+
+	// the same processing one sample at a time, for stages that fuse it into a loop of their own:
+	// call startBlock(), then processSample() with each sample's sidechain peak, then finishBlock().
+	// processSample() returns the linear gain to apply
+	void	   startBlock() noexcept { gainReductionTotal = 0; }
+	SampleType processSample (SampleType sidechainPeak) noexcept;
+	void	   finishBlock (int numSamples) noexcept;
+
+	// in dB, over the last block processed. 0 means no gain reduction
+	SampleType getAverageGainReduction() const noexcept { return averageGainReduction; }
+
+private:
+
+	EnvelopeFollower<SampleType> envelopeFollower;
+	GainComputer<SampleType>	 gainComputer;
+
+	// the envelope, then the gain curve in dB, then the linear gain, all computed in place
+	std::vector<SampleType> gains;
+
+	SampleType gainReductionTotal { 0 };
+	SampleType averageGainReduction { 0 };
+};
+
+}  // namespace Imogen
@@ -0,0 +1,95 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::prepare (double newSamplerate)
+{
+	jassert (newSamplerate > 0.);
+
+	samplerate = newSamplerate;
+	updateCoefficients();
+	reset();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::reset()
+{
+	lastEnvelope = 0;
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setAttackMs (float attackMs)
+{
+	attackTime = attackMs;
+	updateCoefficients();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::setReleaseMs (float releaseMs)
+{
+	releaseTime = releaseMs;
+	updateCoefficients();
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::updateCoefficients()
+{
+	const auto coefficientFor = [sr = samplerate] (float ms)
+	{
+		if (ms <= 0.f)
+			return SampleType (0);
+
+		return static_cast<SampleType> (std::exp (-1000. / (static_cast<double> (ms) * sr)));
+	};
+
+	attackCoeff	 = coefficientFor (attackTime);
+	releaseCoeff = coefficientFor (releaseTime);
+}
+
+template <typename SampleType>
+void EnvelopeFollower<SampleType>::process (const AudioBuffer& input, SampleType* envelope, int numSamples)
+{
+	const auto numChannels = input.getNumChannels();
+
+	jassert (numChannels > 0 && numSamples <= input.getNumSamples());
+
+	juce::FloatVectorOperations::abs (envelope, input.getReadPointer (0), numSamples);
+
+	for (auto chan = 1; chan < numChannels; ++chan)
+	{
+		const auto* samples = input.getReadPointer (chan);
+
+		for (auto i = 0; i < numSamples; ++i)
+			envelope[i] = std::max (envelope[i], std::abs (samples[i]));
+	}
+
+	auto env = lastEnvelope;
+
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		env			= smooth (envelope[i], env);
+		envelope[i] = env;
+	}
+
+	lastEnvelope = env;
+}
+
+template <typename SampleType>
+SampleType EnvelopeFollower<SampleType>::processSample (SampleType peak) noexcept
+{
+	lastEnvelope = smooth (peak, lastEnvelope);
+	return lastEnvelope;
+}
+
+template <typename SampleType>
+SampleType EnvelopeFollower<SampleType>::smooth (SampleType peak, SampleType envelope) const noexcept
+{
+	const auto coeff = peak > envelope ? attackCoeff : releaseCoeff;
+
+	return peak + coeff * (envelope - peak);
+}
+
+template class EnvelopeFollower<float>;
+template class EnvelopeFollower<double>;
+
+}  // namespace Imogen
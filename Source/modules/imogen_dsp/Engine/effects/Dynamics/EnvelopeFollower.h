@@ -0,0 +1,46 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	A peak envelope follower with separate attack and release times.
+	The peak across all channels is taken a whole block at a time; only the smoothing runs sample by sample, since
+	each output depends on the last.
+*/
+template <typename SampleType>
+class EnvelopeFollower
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	void prepare (double samplerate);
+
+	void reset();
+
+	// 0 ms follows every peak instantly
+	void setAttackMs (float attackMs);
+	void setReleaseMs (float releaseMs);
+
+	// writes the linear envelope of the loudest channel of input
+	void process (const AudioBuffer& input, SampleType* envelope, int numSamples);
+
+	// takes one sample's peak level, and returns the envelope
+	SampleType processSample (SampleType peak) noexcept;
+
+private:
+
+	void updateCoefficients();
+
+	SampleType smooth (SampleType peak, SampleType envelope) const noexcept;
+
+	double samplerate { 44100. };
+
+	float attackTime { 0.f }, releaseTime { 0.f };
+
+	SampleType attackCoeff { 0 }, releaseCoeff { 0 };
+
+	SampleType lastEnvelope { 0 };
+};
+
+}  // namespace Imogen
@@ -0,0 +1,47 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void GainComputer<SampleType>::setRatio (SampleType newRatio) noexcept
+{
+	jassert (newRatio >= SampleType (1));
+	ratio = newRatio;
+}
+
+template <typename SampleType>
+void GainComputer<SampleType>::setKnee (SampleType kneeWidthDb) noexcept
+{
+	jassert (kneeWidthDb >= SampleType (0));
+	halfKnee = kneeWidthDb * SampleType (0.5);
+}
+
+template <typename SampleType>
+SampleType GainComputer<SampleType>::getGainDb (SampleType levelDb) const noexcept
+{
+	// how far into the active region the level is, and how many dB of gain change each dB of that costs
+	const auto isCompressor = type == Type::compressor;
+
+	const auto overshoot = isCompressor ? levelDb - threshold : threshold - levelDb;
+	const auto slope	 = isCompressor ? SampleType (1) / ratio - SampleType (1) : SampleType (1) - ratio;
+
+	// a zero-width knee still has to avoid dividing by zero
+	const auto knee		= std::max (halfKnee, std::numeric_limits<SampleType>::epsilon());
+	const auto inKnee	= overshoot + knee;
+	const auto kneeGain = inKnee * inKnee / (knee * SampleType (4));
+
+	const auto amount = overshoot >= knee ? overshoot : (inKnee <= SampleType (0) ? SampleType (0) : kneeGain);
+
+	return std::max (slope * amount, -range);
+}
+
+template <typename SampleType>
+void GainComputer<SampleType>::process (const SampleType* levelDb, SampleType* gainDb, int numSamples) const noexcept
+{
+	for (auto i = 0; i < numSamples; ++i)
+		gainDb[i] = getGainDb (levelDb[i]);
+}
+
+template class GainComputer<float>;
+template class GainComputer<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,49 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	The static curve of a dynamics processor: maps an input level to the gain to apply, both in dB.
+	A compressor acts on levels above the threshold, and an expander on levels below it. The knee is quadratic, and the
+	whole curve is computed without branches so that a block of levels can be processed as a vector.
+*/
+template <typename SampleType>
+class GainComputer
+{
+public:
+
+	enum class Type
+	{
+		compressor,
+		expander
+	};
+
+	void setType (Type newType) noexcept { type = newType; }
+
+	void setThreshold (SampleType thresholdDb) noexcept { threshold = thresholdDb; }
+
+	// for a limiter, pass infinity
+	void setRatio (SampleType newRatio) noexcept;
+
+	void setKnee (SampleType kneeWidthDb) noexcept;
+
+	// the deepest gain reduction applied, in dB
+	void setRange (SampleType maxReductionDb) noexcept { range = maxReductionDb; }
+
+	// gainDb and levelDb may be the same
+	void process (const SampleType* levelDb, SampleType* gainDb, int numSamples) const noexcept;
+
+	SampleType getGainDb (SampleType levelDb) const noexcept;
+
+private:
+
+	Type type { Type::compressor };
+
+	SampleType threshold { 0 };
+	SampleType ratio { 1 };
+	SampleType halfKnee { 0 };
+
+	SampleType range { std::numeric_limits<SampleType>::max() };
+};
+
+}  // namespace Imogen
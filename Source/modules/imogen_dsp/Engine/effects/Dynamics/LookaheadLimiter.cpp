@@ -0,0 +1,175 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setThreshold (SampleType thresholdDb)
+{
+	thresholdGain = DynamicsMath::decibelsToGain (thresholdDb);
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::setReleaseMs (float releaseMs)
+{
+	releaseTime = releaseMs;
+	updateReleaseCoefficient();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::updateReleaseCoefficient()
+{
+	releaseCoeff = static_cast<SampleType> (std::exp (-1000. / (static_cast<double> (releaseTime) * samplerate)));
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::prepare (double newSamplerate, int blocksize, int numChannels, int lookaheadSamples)
+{
+	jassert (lookaheadSamples > 0);
+
+	samplerate = newSamplerate;
+	updateReleaseCoefficient();
+
+	const auto windowLength = lookaheadSamples + 1;
+
+	// the detected peaks can land either side of a sample boundary, so the hold covers one more sample to be sure
+	peakHold.prepare (truePeak ? windowLength + 1 : windowLength);
+
+	averageRing.resize (static_cast<size_t> (windowLength));
+
+	delay = getLatencySamplesFor (lookaheadSamples);
+
+	delayLine.setSize (numChannels, delay, false, false, true);
+
+	upsampler.setNumStages (truePeak ? 2 : 0);
+	upsampler.prepare (numChannels, blocksize);
+
+	if (static_cast<int> (gains.size()) < blocksize)
+		gains.resize (static_cast<size_t> (blocksize));
+
+	reset();
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::reset()
+{
+	peakHold.reset();
+	upsampler.reset();
+
+	std::fill (averageRing.begin(), averageRing.end(), SampleType (1));
+	averageSum = static_cast<double> (averageRing.size());
+	averagePos = 0;
+
+	envelope = 1;
+
+	delayLine.clear();
+	delayPos = 0;
+
+	averageGainReduction = 0;
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::detectPeaks (const AudioBuffer& audio, int numSamples)
+{
+	auto* peaks = gains.data();
+
+	if (! truePeak)
+	{
+		juce::FloatVectorOperations::abs (peaks, audio.getReadPointer (0), numSamples);
+
+		for (auto chan = 1; chan < audio.getNumChannels(); ++chan)
+		{
+			const auto* samples = audio.getReadPointer (chan);
+
+			for (auto i = 0; i < numSamples; ++i)
+				peaks[i] = std::max (peaks[i], std::abs (samples[i]));
+		}
+
+		return;
+	}
+
+	const auto& upsampled = upsampler.upsample (audio);
+	const auto	factor	  = upsampler.getFactor();
+
+	std::fill (peaks, peaks + numSamples, SampleType (0));
+
+	for (auto chan = 0; chan < upsampled.getNumChannels(); ++chan)
+	{
+		const auto* samples = upsampled.getReadPointer (chan);
+
+		for (auto i = 0; i < numSamples; ++i)
+			for (auto j = 0; j < factor; ++j)
+				peaks[i] = std::max (peaks[i], std::abs (samples[i * factor + j]));
+	}
+}
+
+template <typename SampleType>
+void LookaheadLimiter<SampleType>::process (AudioBuffer& audio)
+{
+	const auto numSamples  = audio.getNumSamples();
+	const auto numChannels = audio.getNumChannels();
+
+	if (numSamples == 0)
+		return;
+
+	jassert (numSamples <= static_cast<int> (gains.size()) && numChannels <= delayLine.getNumChannels());
+
+	detectPeaks (audio, numSamples);
+
+	auto* g = gains.data();
+
+	const auto windowLength = static_cast<int> (averageRing.size());
+	const auto averageScale = 1. / static_cast<double> (windowLength);
+
+	auto totalGain = 0.;
+
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		const auto peak	  = peakHold.push (g[i]);
+		const auto target = (peak > thresholdGain && ! bypassed) ? thresholdGain / peak : SampleType (1);
+
+		// attack instantly, since the moving average below does the smoothing; release exponentially
+		envelope = target < envelope ? target : target + releaseCoeff * (envelope - target);
+
+		auto& oldest = averageRing[static_cast<size_t> (averagePos)];
+
+		averageSum += static_cast<double> (envelope) - static_cast<double> (oldest);
+		oldest = envelope;
+
+		if (++averagePos == windowLength)
+			averagePos = 0;
+
+		g[i] = static_cast<SampleType> (averageSum * averageScale);
+
+		totalGain += static_cast<double> (g[i]);
+	}
+
+	averageGainReduction = static_cast<SampleType> (DynamicsMath::gainToDecibels (totalGain / numSamples));
+
+	// delay the signal to line up with its gain, and apply it
+	const auto startPos = delayPos;
+
+	for (auto chan = 0; chan < numChannels; ++chan)
+	{
+		auto* samples = audio.getWritePointer (chan);
+		auto* line	  = delayLine.getWritePointer (chan);
+
+		auto pos = startPos;
+
+		for (auto i = 0; i < numSamples; ++i)
+		{
+			const auto delayed = line[pos];
+			line[pos]		   = samples[i];
+
+			samples[i] = delayed * g[i];
+
+			if (++pos == delay)
+				pos = 0;
+		}
+
+		delayPos = pos;
+	}
+}
+
+template class LookaheadLimiter<float>;
+template class LookaheadLimiter<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SlidingMaximum.h"
+
+namespace Imogen
+{
+/*
+	A brickwall limiter that sees every peak coming.
+	The peak level is held over the lookahead window with a SlidingMaximum, so detection costs the same per sample
+	whatever the lookahead. The gain then releases exponentially and is smoothed by a moving average as long as the
+	window, which ramps it down over the lookahead and reaches the required reduction exactly as the peak comes out of
+	the delay line.
+
+	With true-peak detection, the peaks are measured on a 4x upsampled copy of the signal, so that inter-sample peaks
+	are caught too.
+*/
+template <typename SampleType>
+class LookaheadLimiter
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	void setThreshold (SampleType thresholdDb);
+
+	void setReleaseMs (float releaseMs);
+
+	// takes effect on the next prepare()
+	void setTruePeak (bool shouldUseTruePeak) noexcept { truePeak = shouldUseTruePeak; }
+
+	// keeps delaying the signal, so the latency doesn't change, but applies no gain reduction
+	void setBypassed (bool shouldBeBypassed) noexcept { bypassed = shouldBeBypassed; }
+
+	// lookaheadSamples is at the rate the limiter runs at
+	void prepare (double samplerate, int blocksize, int numChannels, int lookaheadSamples);
+
+	void reset();
+
+	void process (AudioBuffer& audio);
+
+	// the delay the limiter adds to the signal
+	int getLatencySamples() const noexcept { return delay; }
+
+	// the delay a prepare() with this lookahead will add, with the current true-peak setting
+	int getLatencySamplesFor (int lookaheadSamples) const noexcept { return truePeak ? lookaheadSamples + truePeakDelay : lookaheadSamples; }
+
+	// in dB, over the last block processed. 0 means no gain reduction
+	SampleType getAverageGainReduction() const noexcept { return averageGainReduction; }
+
+	// the detection path's upsampler lags the signal by 11.25 samples, so the signal is delayed a little more to match
+	static constexpr auto truePeakDelay = 12;
+
+private:
+
+	void updateReleaseCoefficient();
+
+	void detectPeaks (const AudioBuffer& audio, int numSamples);
+
+	SampleType thresholdGain { 1 };
+
+	float releaseTime { 35.f };
+
+	double samplerate { 44100. };
+
+	SampleType releaseCoeff { 0 };
+
+	bool truePeak { false };
+	bool bypassed { false };
+
+	int delay { 0 };
+
+	SlidingMaximum<SampleType> peakHold;
+
+	// the moving average of the gain
+	std::vector<SampleType> averageRing;
+	double					averageSum { 0. };
+	int						averagePos { 0 };
+
+	SampleType envelope { 1 };
+
+	AudioBuffer delayLine;
+	int			delayPos { 0 };
+
+	Oversampler<SampleType> upsampler;
+
+	// the peaks, and then the gain for each sample
+	std::vector<SampleType> gains;
+
+	SampleType averageGainReduction { 0 };
+};
+
+}  // namespace Imogen
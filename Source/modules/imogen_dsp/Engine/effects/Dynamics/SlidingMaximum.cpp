@@ -0,0 +1,52 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+void SlidingMaximum<SampleType>::prepare (int windowLengthToUse)
+{
+	jassert (windowLengthToUse > 0);
+
+	windowLength = windowLengthToUse;
+	entries.resize (static_cast<size_t> (windowLength));
+
+	reset();
+}
+
+template <typename SampleType>
+void SlidingMaximum<SampleType>::reset()
+{
+	front	= 0;
+	size	= 0;
+	counter = 0;
+}
+
+template <typename SampleType>
+SampleType SlidingMaximum<SampleType>::push (SampleType value) noexcept
+{
+	const auto capacity = windowLength;
+
+	const auto wrap = [capacity] (int index)
+	{ return index >= capacity ? index - capacity : index; };
+
+	// the oldest entry leaves the window
+	if (size > 0 && counter - entries[static_cast<size_t> (front)].index >= static_cast<std::uint32_t> (windowLength))
+	{
+		front = wrap (front + 1);
+		--size;
+	}
+
+	// older entries that aren't bigger than the new value can never be the maximum again
+	while (size > 0 && entries[static_cast<size_t> (wrap (front + size - 1))].value <= value)
+		--size;
+
+	entries[static_cast<size_t> (wrap (front + size))] = { value, counter };
+	++size;
+	++counter;
+
+	return entries[static_cast<size_t> (front)].value;
+}
+
+template class SlidingMaximum<float>;
+template class SlidingMaximum<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,44 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	The maximum of the last N values pushed, in amortized constant time per value whatever N is.
+	Keeps a monotonic deque in a ring buffer: each value is pushed and popped at most once, and a value is dropped as
+	soon as a newer one at least as large arrives, since it can never be the maximum again.
+*/
+template <typename SampleType>
+class SlidingMaximum
+{
+public:
+
+	// allocates
+	void prepare (int windowLengthToUse);
+
+	void reset();
+
+	// returns the maximum of this value and the windowLength - 1 values before it
+	SampleType push (SampleType value) noexcept;
+
+	int getWindowLength() const noexcept { return windowLength; }
+
+private:
+
+	struct Entry
+	{
+		SampleType	  value;
+		std::uint32_t index;
+	};
+
+	std::vector<Entry> entries;
+
+	int windowLength { 1 };
+
+	// the deque's front and number of entries, within the ring
+	int front { 0 }, size { 0 };
+
+	// wraps around, which the expiry check allows for
+	std::uint32_t counter { 0 };
+};
+
+}  // namespace Imogen
@@ -0,0 +1,154 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	Runs a fixed list of effect stages in order, with every call resolved at compile time.
+
+	Each stage needs a process() function taking the chain's arguments. A stage that can be switched off also provides
+	isEnabled(), and may provide bypass() for whatever it needs to do when it's skipped (eg, resetting its meter).
+
+	The set of enabled stages is a bitmask, with bit N standing for the Nth stage. Masks passed to processSpecialized()
+	get their own instantiation of the whole chain with no toggle checks in it; any other combination falls back to
+	checking the mask stage by stage.
+*/
+template <typename... Stages>
+class EffectChain
+{
+public:
+
+	using Mask = std::uint32_t;
+
+	static constexpr auto numStages = sizeof...(Stages);
+
+	static_assert (numStages > 0 && numStages <= 32);
+
+	static constexpr Mask allStages = static_cast<Mask> ((std::uint64_t (1) << numStages) - 1);
+
+	template <typename Stage>
+	static constexpr Mask stageBit()
+	{
+		return Mask (1) << indexOf<Stage, Stages...>();
+	}
+
+	explicit EffectChain (Stages&... stagesToUse)
+		: stages (stagesToUse...)
+	{
+	}
+
+	Mask getEnabledStages() const
+	{
+		return getEnabledStages (std::index_sequence_for<Stages...>());
+	}
+
+	template <Mask... Specializations, typename... Args>
+	void processSpecialized (Args&... args)
+	{
+		const auto enabled = getEnabledStages();
+
+		if (! (tryProcess<Specializations> (enabled, args...) || ...))
+			process (enabled, args...);
+	}
+
+	template <Mask EnabledStages, typename... Args>
+	void process (Args&... args)
+	{
+		processStages<EnabledStages> (std::index_sequence_for<Stages...>(), args...);
+	}
+
+	template <typename... Args>
+	void process (Mask enabledStages, Args&... args)
+	{
+		processStages (enabledStages, std::index_sequence_for<Stages...>(), args...);
+	}
+
+private:
+
+	template <typename Stage, typename First, typename... Rest>
+	static constexpr std::size_t indexOf()
+	{
+		if constexpr (std::is_same_v<Stage, First>)
+			return 0;
+		else
+			return 1 + indexOf<Stage, Rest...>();
+	}
+
+	template <typename T, typename = void>
+	struct HasToggle : std::false_type
+	{
+	};
+
+	template <typename T>
+	struct HasToggle<T, std::void_t<decltype (std::declval<const T&>().isEnabled())>> : std::true_type
+	{
+	};
+
+	template <typename T, typename = void>
+	struct HasBypass : std::false_type
+	{
+	};
+
+	template <typename T>
+	struct HasBypass<T, std::void_t<decltype (std::declval<T&>().bypass())>> : std::true_type
+	{
+	};
+
+	template <std::size_t... Indices>
+	Mask getEnabledStages (std::index_sequence<Indices...>) const
+	{
+		return ((isEnabled (std::get<Indices> (stages)) ? (Mask (1) << Indices) : Mask (0)) | ...);
+	}
+
+	template <typename Stage>
+	static bool isEnabled (const Stage& stage)
+	{
+		if constexpr (HasToggle<Stage>::value)
+			return stage.isEnabled();
+		else
+			return true;
+	}
+
+	template <Mask EnabledStages, typename... Args>
+	bool tryProcess (Mask enabled, Args&... args)
+	{
+		if (enabled != EnabledStages)
+			return false;
+
+		process<EnabledStages> (args...);
+		return true;
+	}
+
+	template <Mask EnabledStages, std::size_t... Indices, typename... Args>
+	void processStages (std::index_sequence<Indices...>, Args&... args)
+	{
+		(processStage<((EnabledStages >> Indices) & 1) != 0> (std::get<Indices> (stages), args...), ...);
+	}
+
+	template <std::size_t... Indices, typename... Args>
+	void processStages (Mask enabledStages, std::index_sequence<Indices...>, Args&... args)
+	{
+		(processStage (((enabledStages >> Indices) & 1) != 0, std::get<Indices> (stages), args...), ...);
+	}
+
+	template <bool Enabled, typename Stage, typename... Args>
+	static void processStage (Stage& stage, Args&... args)
+	{
+		if constexpr (Enabled)
+			stage.process (args...);
+		else if constexpr (HasBypass<Stage>::value)
+			stage.bypass();
+	}
+
+	template <typename Stage, typename... Args>
+	static void processStage (bool enabled, Stage& stage, Args&... args)
+	{
+		if (enabled)
+			processStage<true> (stage, args...);
+		else
+			processStage<false> (stage, args...);
+	}
+
+	std::tuple<Stages&...> stages;
+};
+
+}  // namespace Imogen
@@ -0,0 +1,210 @@
+namespace Imogen
+{
+template <typename SampleType>
+EffectsPipeline<SampleType>::EffectsPipeline (Callback&& callbackToUse)
+	: juce::Thread ("Imogen effects pipeline"), callback (std::move (callbackToUse))
+{
+}
+
+template <typename SampleType>
+EffectsPipeline<SampleType>::~EffectsPipeline()
+{
+	release();
+}
+
+template <typename SampleType>
+void EffectsPipeline<SampleType>::prepare (double samplerate, int chunkSize)
+{
+	release();
+
+	if (! enabled)
+		return;
+
+	for (auto& slot : slots)
+		slot.buffer.setSize (2, chunkSize, false, true, true);
+
+	// half a chunk, which leaves the audio thread the rest of it for everything else
+	maxWaitTicks = static_cast<juce::int64> (juce::Time::getHighResolutionTicksPerSecond() * 0.5 * chunkSize / samplerate);
+
+	startThread (juce::Thread::realtimeAudioPriority);
+}
+
+template <typename SampleType>
+void EffectsPipeline<SampleType>::release()
+{
+	stopThread (maxWaitMs * 10);
+
+	for (auto& slot : slots)
+		slot.state.store (SlotState::empty);
+
+	numChunksQueued = 0;
+}
+
+template <typename SampleType>
+void EffectsPipeline<SampleType>::process (AudioBuffer& audio)
+{
+	// the new chunk is copied in first, but only handed to the worker once the chunk before it is done with, so the
+	// chunks are processed in order and never on two threads at once
+	auto& slot = getSlot (numChunksQueued);
+
+	const auto staged = stage (slot, audio);
+
+	collect (audio);
+
+	if (staged)
+	{
+		slot.state.store (SlotState::queued, std::memory_order_release);
+		notify();
+	}
+
+	++numChunksQueued;
+}
+
+template <typename SampleType>
+bool EffectsPipeline<SampleType>::stage (Slot& slot, const AudioBuffer& audio)
+{
+	const auto numSamples = audio.getNumSamples();
+
+	// if the worker is still stuck on the chunk that last used this slot, this chunk is dropped, and comes out as silence
+	if (slot.state.load (std::memory_order_acquire) != SlotState::empty || numSamples > slot.buffer.getNumSamples())
+		return false;
+
+	for (auto chan = 0; chan < 2; ++chan)
+		slot.buffer.copyFrom (chan, 0, audio, chan, 0, numSamples);
+
+	slot.numSamples = numSamples;
+	slot.sequence	= numChunksQueued;
+
+	return true;
+}
+
+template <typename SampleType>
+void EffectsPipeline<SampleType>::collect (AudioBuffer& audio)
+{
+	const auto numSamples = audio.getNumSamples();
+
+	if (numChunksQueued == 0)
+	{
+		audio.clear();
+		return;
+	}
+
+	auto& slot = getSlot (numChunksQueued - 1);
+
+	auto state = slot.state.load (std::memory_order_acquire);
+
+	// the worker hasn't started on it, so it's processed here. If the worker is still on a chunk it was late with, the
+	// two can't run at once, so this one is dropped instead
+	if (state == SlotState::queued)
+	{
+		const auto claimedState = isWorkerBusy() ? SlotState::empty : SlotState::processing;
+
+		if (slot.state.compare_exchange_strong (state, claimedState, std::memory_order_acq_rel))
+		{
+			if (claimedState == SlotState::empty)
+			{
+				audio.clear();
+				return;
+			}
+
+			inlineAlias.setDataToReferTo (slot.buffer.getArrayOfWritePointers(), 2, slot.numSamples);
+			callback (inlineAlias);
+
+			state = SlotState::processed;
+		}
+	}
+
+	// the worker is partway through it
+	if (state == SlotState::processing)
+	{
+		const auto deadline = juce::Time::getHighResolutionTicks() + maxWaitTicks;
+
+		while (state == SlotState::processing && juce::Time::getHighResolutionTicks() < deadline)
+		{
+			juce::Thread::yield();
+			state = slot.state.load (std::memory_order_acquire);
+		}
+
+		// it'll free the slot when it's done
+		if (state == SlotState::processing && slot.state.compare_exchange_strong (state, SlotState::abandoned, std::memory_order_acq_rel))
+		{
+			audio.clear();
+			return;
+		}
+	}
+
+	// it was dropped when it was queued, because the worker was stuck
+	if (state != SlotState::processed)
+	{
+		audio.clear();
+		return;
+	}
+
+	// the latency is only constant if every chunk is the same length
+	jassert (slot.numSamples == numSamples);
+
+	const auto numToCopy = std::min (numSamples, slot.numSamples);
+
+	for (auto chan = 0; chan < 2; ++chan)
+		audio.copyFrom (chan, 0, slot.buffer, chan, 0, numToCopy);
+
+	if (numToCopy < numSamples)
+		audio.clear (numToCopy, numSamples - numToCopy);
+
+	slot.state.store (SlotState::empty, std::memory_order_release);
+}
+
+template <typename SampleType>
+bool EffectsPipeline<SampleType>::isWorkerBusy() const noexcept
+{
+	for (const auto& slot : slots)
+	{
+		const auto state = slot.state.load (std::memory_order_acquire);
+
+		if (state == SlotState::processing || state == SlotState::abandoned)
+			return true;
+	}
+
+	return false;
+}
+
+template <typename SampleType>
+void EffectsPipeline<SampleType>::run()
+{
+	while (! threadShouldExit())
+	{
+		// the oldest chunk waiting comes first
+		Slot* next = nullptr;
+
+		for (auto& slot : slots)
+			if (slot.state.load (std::memory_order_acquire) == SlotState::queued)
+				if (next == nullptr || static_cast<std::int32_t> (slot.sequence - next->sequence) < 0)
+					next = &slot;
+
+		// the audio thread wakes the worker as soon as it queues a chunk
+		if (next == nullptr)
+		{
+			wait (maxWaitMs);
+			continue;
+		}
+
+		auto state = SlotState::queued;
+
+		// the audio thread got to it first
+		if (! next->state.compare_exchange_strong (state, SlotState::processing, std::memory_order_acq_rel))
+			continue;
+
+		workAlias.setDataToReferTo (next->buffer.getArrayOfWritePointers(), 2, next->numSamples);
+		callback (workAlias);
+
+		state = SlotState::processing;
+
+		if (! next->state.compare_exchange_strong (state, SlotState::processed, std::memory_order_acq_rel))
+			next->state.store (SlotState::empty, std::memory_order_release);
+	}
+}
+
+template class EffectsPipeline<float>;
+template class EffectsPipeline<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,93 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	Runs part of the effects chain on a dedicated worker thread, one chunk behind the audio thread.
+	Each chunk is handed over in a slot of its own, and the slots change hands with atomic state changes alone, so the
+	audio thread never locks. It takes back the worker's output for the chunk before, and then queues the chunk it's
+	given. When the host's blocks span several chunks, the worker can't have started on the chunk before yet, so the
+	audio thread processes it itself. If the worker is partway through it, the audio thread waits a little for it, and
+	only if it's still not done is it output as silence and the late result thrown away, so the latency never shifts.
+*/
+template <typename SampleType>
+class EffectsPipeline : private juce::Thread
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+	using Callback	  = std::function<void (AudioBuffer&)>;
+
+	explicit EffectsPipeline (Callback&& callbackToUse);
+
+	~EffectsPipeline() override;
+
+	// takes effect on the next prepare()
+	void setEnabled (bool shouldBeEnabled) noexcept { enabled = shouldBeEnabled; }
+
+	bool isEnabled() const noexcept { return enabled; }
+
+	// every chunk passed to process() should be this long. The pipeline's latency is one chunk
+	void prepare (double samplerate, int chunkSize);
+
+	void release();
+
+	// replaces the contents of audio with the processed signal from one chunk ago
+	void process (AudioBuffer& audio);
+
+private:
+
+	void run() final;
+
+	void collect (AudioBuffer& audio);
+
+	// true while the worker is running the callback, on any slot
+	bool isWorkerBusy() const noexcept;
+
+	enum class SlotState
+	{
+		empty,
+		queued,
+		processing,
+		processed,
+		abandoned  // the audio thread gave up on it while the worker was processing it
+	};
+
+	struct Slot
+	{
+		AudioBuffer buffer;
+
+		int			  numSamples { 0 };
+		std::uint32_t sequence { 0 };
+
+		std::atomic<SlotState> state { SlotState::empty };
+	};
+
+	// the chunk being collected, the chunk being queued, and one spare for a chunk the worker is late with
+	static constexpr auto numSlots = 3;
+
+	Slot& getSlot (std::uint32_t sequence) noexcept { return slots[sequence % numSlots]; }
+
+	// copies the chunk into the slot, without handing it to the worker yet
+	bool stage (Slot& slot, const AudioBuffer& audio);
+
+	Callback callback;
+
+	bool enabled { false };
+
+	std::array<Slot, numSlots> slots;
+
+	// only touched by the audio thread
+	std::uint32_t numChunksQueued { 0 };
+	AudioBuffer	  inlineAlias;
+
+	// only touched by the worker
+	AudioBuffer workAlias;
+
+	// how long the audio thread waits for a chunk the worker is partway through
+	juce::int64 maxWaitTicks { 0 };
+
+	static constexpr auto maxWaitMs = 100;
+};
+
+}  // namespace Imogen
@@ -5,35 +5,44 @@ template <typename SampleType>
 Compressor<SampleType>::Compressor (State& stateToUse)
 	: state (stateToUse)
 {
-	//    static constexpr auto compressorAttackMs  = 4.0f;
-	//    static constexpr auto compressorReleaseMs = 200.0f;
+	for (auto* comp : { &dryComp, &wetComp })
+	{
+		comp->setKnee (SampleType (kneeDb));
+		comp->setAttackMs (attackMs);
+		comp->setReleaseMs (releaseMs);
+	}
+}
+
+template <typename SampleType>
+bool Compressor<SampleType>::isEnabled() const
+{
+	return parameters.compToggle->get();
 }
 
 template <typename SampleType>
 void Compressor<SampleType>::process (AudioBuffer& dry, AudioBuffer& wet)
 {
-	if (parameters.compToggle->get())
-	{
-		updateCompressorAmount (parameters.compAmount->get());
+	updateCompressorAmount (parameters.compAmount->get());
 
-		dryComp.process (dry);
-		wetComp.process (wet);
+	dryComp.process (dry);
+	wetComp.process (wet);
 
-		meters.compRedux->set (static_cast<float> (dryComp.getAverageGainReduction() + wetComp.getAverageGainReduction()) * 0.5f);
-	}
-	else
-	{
-		meters.compRedux->set (0.f);
-	}
+	meters.compRedux->set (Meters::toReduction ((dryComp.getAverageGainReduction() + wetComp.getAverageGainReduction()) * 0.5));
+}
+
+template <typename SampleType>
+void Compressor<SampleType>::bypass()
+{
+	meters.compRedux->set (0.f);
 }
 
 template <typename SampleType>
 void Compressor<SampleType>::updateCompressorAmount (int amount)
 {
-	const auto a = static_cast<float> (amount) * 0.01f;
+	const auto a = static_cast<SampleType> (amount) * SampleType (0.01);
 
-	const auto thresh = juce::jmap (a, 0.f, -60.f);
-	const auto ratio  = juce::jmap (a, 1.f, 10.f);
+	const auto thresh = juce::jmap (a, SampleType (0), SampleType (-60));
+	const auto ratio  = juce::jmap (a, SampleType (1), SampleType (10));
 
 	dryComp.setThreshold (thresh);
 	dryComp.setRatio (ratio);
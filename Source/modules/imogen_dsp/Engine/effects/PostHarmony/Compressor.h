@@ -9,8 +9,12 @@ struct Compressor
 
 	Compressor (State& stateToUse);
 
+	bool isEnabled() const;
+
 	void process (AudioBuffer& dry, AudioBuffer& wet);
 
+	void bypass();
+
 	void prepare (double samplerate, int blocksize);
 
 private:
@@ -21,7 +25,11 @@ private:
 	Parameters& parameters { state.parameters };
 	Meters&		meters { state.meters };
 
-	dsp::FX::Compressor<SampleType> dryComp, wetComp;
+	DynamicsProcessor<SampleType> dryComp, wetComp;
+
+	static constexpr auto attackMs	= 4.f;
+	static constexpr auto releaseMs = 200.f;
+	static constexpr auto kneeDb	= 6;
 };
 
 }  // namespace Imogen
@@ -4,40 +4,79 @@ namespace Imogen
 template <typename SampleType>
 DeEsser<SampleType>::DeEsser (State& stateToUse) : state (stateToUse)
 {
+	for (auto* ds : { &dryDS, &wetDS })
+	{
+		ds->setKnee (SampleType (kneeDb));
+		ds->setAttackMs (attackMs);
+		ds->setReleaseMs (releaseMs);
+	}
+}
+
+template <typename SampleType>
+bool DeEsser<SampleType>::isEnabled() const
+{
+	return parameters.deEsserToggle->get();
 }
 
 template <typename SampleType>
 void DeEsser<SampleType>::process (AudioBuffer& dry, AudioBuffer& wet)
 {
-	if (parameters.deEsserToggle->get())
+	const auto thresh = static_cast<SampleType> (parameters.deEsserThresh->get());
+	const auto ratio  = juce::jmap (static_cast<SampleType> (parameters.deEsserAmount->get()) * SampleType (0.01),
+									SampleType (1), SampleType (maxRatio));
+
+	for (auto* ds : { &dryDS, &wetDS })
 	{
-		const auto thresh = parameters.deEsserThresh->get();
-		const auto amount = parameters.deEsserAmount->get();
+		ds->setThreshold (thresh);
+		ds->setRatio (ratio);
+	}
 
-		dryDS.setThresh (thresh);
-		dryDS.setDeEssAmount (amount);
+	process (dry, dryFilter, dryDS);
+	process (wet, wetFilter, wetDS);
 
-		wetDS.setThresh (thresh);
-		wetDS.setDeEssAmount (amount);
+	meters.deEssRedux->set (Meters::toReduction ((dryDS.getAverageGainReduction() + wetDS.getAverageGainReduction()) * 0.5));
+}
 
-		dryDS.process (dry);
-		wetDS.process (wet);
+template <typename SampleType>
+void DeEsser<SampleType>::process (AudioBuffer& audio, dsp::FX::Filter<SampleType>& filter, DynamicsProcessor<SampleType>& deEsser)
+{
+	const auto numChannels = audio.getNumChannels();
+	const auto numSamples  = audio.getNumSamples();
 
-		meters.compRedux->set (static_cast<float> (dryDS.getAverageGainReduction() + wetDS.getAverageGainReduction()) * 0.5f);
-	}
-	else
-	{
-		meters.deEssRedux->set (0.f);
-	}
+	sidechainAlias.setDataToReferTo (sidechainBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+	for (auto chan = 0; chan < numChannels; ++chan)
+		sidechainAlias.copyFrom (chan, 0, audio, chan, 0, numSamples);
+
+	filter.process (sidechainAlias);
+
+	deEsser.process (sidechainAlias, audio);
+}
+
+template <typename SampleType>
+void DeEsser<SampleType>::bypass()
+{
+	meters.deEssRedux->set (0.f);
 }
 
 template <typename SampleType>
 void DeEsser<SampleType>::prepare (double samplerate, int blocksize)
 {
+	dryFilter.prepare (samplerate, blocksize);
+	wetFilter.prepare (samplerate, blocksize);
+
 	dryDS.prepare (samplerate, blocksize);
 	wetDS.prepare (samplerate, blocksize);
 }
 
+template <typename SampleType>
+void DeEsser<SampleType>::requestBuffers (BufferArena<SampleType>& arena)
+{
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	arena.request (sidechainBuffer, 2, Stage::postHarmony, Stage::postHarmony);
+}
+
 template struct DeEsser<float>;
 template struct DeEsser<double>;
 
@@ -9,17 +9,37 @@ struct DeEsser
 
 	DeEsser (State& stateToUse);
 
+	bool isEnabled() const;
+
 	void process (AudioBuffer& dry, AudioBuffer& wet);
 
+	void bypass();
+
 	void prepare (double samplerate, int blocksize);
 
+	void requestBuffers (BufferArena<SampleType>& arena);
+
 private:
 
+	void process (AudioBuffer& audio, dsp::FX::Filter<SampleType>& filter, DynamicsProcessor<SampleType>& deEsser);
+
 	State&		state;
 	Parameters& parameters { state.parameters };
 	Meters&		meters { state.meters };
 
-	dsp::FX::DeEsser<SampleType> dryDS, wetDS;
+	// the gain is keyed from the sibilant band only, and applied to the whole signal
+	dsp::FX::Filter<SampleType> dryFilter { dsp::FX::FilterType::HighPass, sidechainHz };
+	dsp::FX::Filter<SampleType> wetFilter { dsp::FX::FilterType::HighPass, sidechainHz };
+
+	DynamicsProcessor<SampleType> dryDS, wetDS;
+
+	AudioBuffer sidechainBuffer, sidechainAlias;
+
+	static constexpr auto sidechainHz = 6000.f;
+	static constexpr auto attackMs	  = 1.f;
+	static constexpr auto releaseMs	  = 60.f;
+	static constexpr auto maxRatio	  = 8;
+	static constexpr auto kneeDb	  = 3;
 };
 
 }  // namespace Imogen
@@ -6,20 +6,25 @@ Delay<SampleType>::Delay (State& stateToUse) : state (stateToUse)
 {
 }
 
+template <typename SampleType>
+bool Delay<SampleType>::isEnabled() const
+{
+	return parameters.delayToggle->get();
+}
+
 template <typename SampleType>
 void Delay<SampleType>::process (AudioBuffer& audio)
 {
-	if (parameters.delayToggle->get())
-	{
-		delay.setDryWet (parameters.delayDryWet->get());
-
-		delay.process (audio);
-		meters.delayLevel->set (static_cast<float> (delay.getAverageGainReduction()));
-	}
-	else
-	{
-		meters.delayLevel->set (-60.f);
-	}
+	delay.setDryWet (parameters.delayDryWet->get());
+
+	delay.process (audio);
+	meters.delayLevel->set (static_cast<float> (delay.getAverageGainReduction()));
+}
+
+template <typename SampleType>
+void Delay<SampleType>::bypass()
+{
+	meters.delayLevel->set (-60.f);
 }
 
 template <typename SampleType>
@@ -9,8 +9,12 @@ struct Delay
 
 	Delay (State& stateToUse);
 
+	bool isEnabled() const;
+
 	void process (AudioBuffer& audio);
 
+	void bypass();
+
 	void prepare (double samplerate, int blocksize);
 
 private:
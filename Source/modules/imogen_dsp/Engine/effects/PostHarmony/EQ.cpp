@@ -17,11 +17,14 @@ EQ<SampleType>::EQ (EQState& params)
 }
 
 template <typename SampleType>
-void EQ<SampleType>::process (AudioBuffer& dry, AudioBuffer& wet)
+bool EQ<SampleType>::isEnabled() const
 {
-	if (! parameters.eqToggle->get())
-		return;
+	return parameters.eqToggle->get();
+}
 
+template <typename SampleType>
+void EQ<SampleType>::process (AudioBuffer& dry, AudioBuffer& wet)
+{
 	updateLowShelf (parameters.eqLowShelfFreq->get(), parameters.eqLowShelfQ->get(), parameters.eqLowShelfGain->get());
 	updateHighShelf (parameters.eqHighShelfFreq->get(), parameters.eqHighShelfQ->get(), parameters.eqHighShelfGain->get());
 	updatePeak (parameters.eqPeakFreq->get(), parameters.eqPeakQ->get(), parameters.eqPeakGain->get());
@@ -10,6 +10,8 @@ struct EQ
 
 	EQ (EQState& params);
 
+	bool isEnabled() const;
+
 	void process (AudioBuffer& dry, AudioBuffer& wet);
 
 	void prepare (double samplerate, int blocksize);
@@ -4,32 +4,70 @@ namespace Imogen
 template <typename SampleType>
 Limiter<SampleType>::Limiter (State& stateToUse) : state (stateToUse)
 {
-	//    static constexpr auto limiterThreshDb     = 0.0f;
-	//    static constexpr auto limiterReleaseMs    = 35.0f;
+	limiter.setThreshold (SampleType (threshDb));
+	limiter.setReleaseMs (releaseMs);
 }
 
 template <typename SampleType>
 void Limiter<SampleType>::process (AudioBuffer& audio)
 {
-	if (parameters.limiterToggle->get())
+	// the signal always goes through the oversampler and the lookahead, so that the latency stays constant
+	auto& limiterInput = oversample ? oversampler.upsample (audio) : audio;
+
+	const auto isOn = parameters.limiterToggle->get();
+
+	limiter.setBypassed (! isOn);
+	limiter.process (limiterInput);
+
+	meters.limRedux->set (isOn ? Meters::toReduction (limiter.getAverageGainReduction()) : 0.f);
+
+	if (oversample)
+		oversampler.downsample (audio);
+
+	const auto numSamples = audio.getNumSamples();
+	meters.outputLevelL->set (static_cast<float> (audio.getRMSLevel (0, 0, numSamples)));
+	meters.outputLevelR->set (static_cast<float> (audio.getRMSLevel (1, 0, numSamples)));
+}
+
+template <typename SampleType>
+void Limiter<SampleType>::prepare (double samplerate, int blocksize)
+{
+	if (oversample)
 	{
-		limiter.process (audio);
-		meters.limRedux->set (static_cast<float> (limiter.getAverageGainReduction()));
+		oversampler.prepare (2, blocksize);
+
+		const auto factor = oversampler.getFactor();
+
+		// the halfband cascade's own delay isn't a whole number of samples at the session rate. The lookahead makes up the
+		// difference, so that an offline render lines up exactly with the latency reported
+		limiter.prepare (samplerate * factor, blocksize * factor, 2,
+						 lookaheadSamples * factor + oversampler.getLatencyPaddingSamples());
 	}
 	else
 	{
-		meters.limRedux->set (0.f);
+		limiter.prepare (samplerate, blocksize, 2, lookaheadSamples);
 	}
+}
 
-	const auto numSamples = audio.getNumSamples();
-	meters.outputLevelL->set (static_cast<float> (audio.getRMSLevel (0, 0, numSamples)));
-	meters.outputLevelR->set (static_cast<float> (audio.getRMSLevel (1, 0, numSamples)));
+template <typename SampleType>
+void Limiter<SampleType>::configure (double samplerate, bool shouldOversample)
+{
+	oversample = shouldOversample;
+	oversampler.setNumStages (shouldOversample ? numOversamplingStages : 0);
+
+	lookaheadSamples = std::max (1, juce::roundToInt (samplerate * lookaheadMs * 0.001));
+
+	// the oversampled limiter already sees the peaks between the original samples
+	limiter.setTruePeak (! shouldOversample && parameters.engineState.limiterTruePeak->get());
 }
 
 template <typename SampleType>
-void Limiter<SampleType>::prepare (double samplerate, int blocksize)
+int Limiter<SampleType>::getLatencySamples() const
 {
-	limiter.prepare (samplerate, blocksize);
+	if (oversample)
+		return oversampler.getLatencySamples() + lookaheadSamples;
+
+	return limiter.getLatencySamplesFor (lookaheadSamples);
 }
 
 template struct Limiter<float>;
@@ -13,13 +13,31 @@ struct Limiter
 
 	void prepare (double samplerate, int blocksize);
 
+	// call before prepare(). The lookahead, and the oversampled limiter, introduce latency; see getLatencySamples()
+	void configure (double samplerate, bool shouldOversample);
+
+	int getLatencySamples() const;
+
 private:
 
 	State&		state;
 	Parameters& parameters { state.parameters };
 	Meters&		meters { state.meters };
 
-	dsp::FX::Limiter<SampleType> limiter;
+	LookaheadLimiter<SampleType> limiter;
+
+	Oversampler<SampleType> oversampler;
+
+	bool oversample { false };
+
+	// at the session rate
+	int lookaheadSamples { 1 };
+
+	static constexpr auto numOversamplingStages = 2;  // 4x
+
+	static constexpr auto threshDb	  = 0;
+	static constexpr auto releaseMs	  = 35.f;
+	static constexpr auto lookaheadMs = 2.;
 };
 
 }  // namespace Imogen
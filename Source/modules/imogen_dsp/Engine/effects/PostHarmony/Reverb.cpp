@@ -6,34 +6,127 @@ Reverb<SampleType>::Reverb (State& stateToUse) : state (stateToUse)
 {
 }
 
+template <typename SampleType>
+bool Reverb<SampleType>::isEnabled() const
+{
+	return parameters.reverbToggle->get();
+}
+
 template <typename SampleType>
 void Reverb<SampleType>::process (AudioBuffer& audio)
 {
-	if (parameters.reverbToggle->get())
-	{
-		reverb.setDryWet (parameters.reverbDryWet->get());
-		reverb.setDuckAmount (parameters.reverbDuck->get());
-		reverb.setLoCutFrequency (parameters.reverbLoCut->get());
-		reverb.setHiCutFrequency (parameters.reverbHiCut->get());
+	SampleType level;
 
-		const auto d = static_cast<float> (parameters.reverbDecay->get()) * 0.01f;
-		reverb.setDamping (1.f - d);
-		reverb.setRoomSize (d);
+	if (fadeSamplesRemaining > 0)
+		processCrossfade (audio, level);
+	else
+		processWith (lowCpuMode, audio, level);
 
-		SampleType level;
-		reverb.process (audio, &level);
-		meters.reverbLevel->set (static_cast<float> (level));
+	meters.reverbLevel->set (static_cast<float> (level));
+}
+
+template <typename SampleType>
+void Reverb<SampleType>::processWith (bool mono, AudioBuffer& audio, SampleType& level)
+{
+	if (mono)
+	{
+		processMono (audio, level);
 	}
 	else
 	{
-		meters.reverbLevel->set (-60.f);
+		updateParameters (reverb, parameters.reverbDryWet->get());
+		reverb.process (audio, &level);
+	}
+}
+
+template <typename SampleType>
+void Reverb<SampleType>::processCrossfade (AudioBuffer& audio, SampleType& level)
+{
+	const auto numSamples = audio.getNumSamples();
+
+	fadeAlias.setDataToReferTo (fadeBuffer.getArrayOfWritePointers(), 2, numSamples);
+
+	for (auto chan = 0; chan < 2; ++chan)
+		fadeAlias.copyFrom (chan, 0, audio, chan, 0, numSamples);
+
+	SampleType oldLevel;
+
+	processWith (! lowCpuMode, fadeAlias, oldLevel);
+	processWith (lowCpuMode, audio, level);
+
+	const auto numFading = std::min (numSamples, fadeSamplesRemaining);
+
+	const auto startGain = static_cast<SampleType> (fadeSamplesRemaining) / static_cast<SampleType> (fadeLength);
+	const auto endGain	 = static_cast<SampleType> (fadeSamplesRemaining - numFading) / static_cast<SampleType> (fadeLength);
+
+	for (auto chan = 0; chan < 2; ++chan)
+	{
+		audio.applyGainRamp (chan, 0, numFading, SampleType (1) - startGain, SampleType (1) - endGain);
+		audio.addFromWithRamp (chan, 0, fadeAlias.getReadPointer (chan), numFading, startGain, endGain);
 	}
+
+	fadeSamplesRemaining -= numFading;
+}
+
+template <typename SampleType>
+void Reverb<SampleType>::bypass()
+{
+	meters.reverbLevel->set (-60.f);
+}
+
+template <typename SampleType>
+void Reverb<SampleType>::processMono (AudioBuffer& audio, SampleType& level)
+{
+	const auto numSamples = audio.getNumSamples();
+
+	monoAlias.setDataToReferTo (monoBuffer.getArrayOfWritePointers(), 1, numSamples);
+
+	monoAlias.copyFrom (0, 0, audio, 0, 0, numSamples);
+	monoAlias.addFrom (0, 0, audio, 1, 0, numSamples);
+	monoAlias.applyGain (SampleType (0.5));
+
+	// the mono reverb only produces the wet signal, which is mixed back into both channels here
+	updateParameters (monoReverb, 100);
+	monoReverb.process (monoAlias, &level);
+
+	const auto wetMix = static_cast<SampleType> (parameters.reverbDryWet->get()) * SampleType (0.01);
+
+	for (auto chan = 0; chan < audio.getNumChannels(); ++chan)
+	{
+		audio.applyGain (chan, 0, numSamples, SampleType (1) - wetMix);
+		audio.addFrom (chan, 0, monoAlias, 0, 0, numSamples, wetMix);
+	}
+}
+
+template <typename SampleType>
+void Reverb<SampleType>::updateParameters (dsp::FX::Reverb& reverbToUpdate, int dryWet)
+{
+	reverbToUpdate.setDryWet (dryWet);
+	reverbToUpdate.setDuckAmount (parameters.reverbDuck->get());
+	reverbToUpdate.setLoCutFrequency (parameters.reverbLoCut->get());
+	reverbToUpdate.setHiCutFrequency (parameters.reverbHiCut->get());
+
+	const auto d = static_cast<float> (parameters.reverbDecay->get()) * 0.01f;
+	reverbToUpdate.setDamping (1.f - d);
+	reverbToUpdate.setRoomSize (d);
 }
 
 template <typename SampleType>
 void Reverb<SampleType>::prepare (double samplerate, int blocksize)
 {
 	reverb.prepare (blocksize, samplerate, 2);
+	monoReverb.prepare (blocksize, samplerate, 1);
+
+	// the incoming reverb starts from silence, so the fade lasts as long as it takes to build up
+	fadeLength			 = std::max (blocksize, juce::roundToInt (samplerate * buildUpMs * 0.001));
+	fadeSamplesRemaining = 0;
+}
+
+template <typename SampleType>
+void Reverb<SampleType>::requestBuffers (BufferArena<SampleType>& arena, typename BufferArena<SampleType>::Stage firstUse)
+{
+	arena.request (monoBuffer, 1, firstUse, BufferArena<SampleType>::Stage::postHarmony);
+	arena.request (fadeBuffer, 2, firstUse, BufferArena<SampleType>::Stage::postHarmony);
 }
 
 template <typename SampleType>
@@ -42,6 +135,30 @@ void Reverb<SampleType>::setWidth (float width)
 	reverb.setWidth (width);
 }
 
+template <typename SampleType>
+void Reverb<SampleType>::setLowCpuMode (bool shouldUseLowCpuMode)
+{
+	if (shouldUseLowCpuMode == lowCpuMode)
+		return;
+
+	lowCpuMode = shouldUseLowCpuMode;
+
+	// switching back partway through a fade just reverses it, as both reverbs have been running all along
+	if (fadeSamplesRemaining > 0)
+	{
+		fadeSamplesRemaining = fadeLength - fadeSamplesRemaining;
+		return;
+	}
+
+	fadeSamplesRemaining = fadeLength;
+
+	// it hasn't been fed since it was last switched away from, so it still holds that moment's tail
+	if (lowCpuMode)
+		monoReverb.reset();
+	else
+		reverb.reset();
+}
+
 template struct Reverb<float>;
 template struct Reverb<double>;
 
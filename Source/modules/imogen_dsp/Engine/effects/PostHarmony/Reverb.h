@@ -9,19 +9,50 @@ struct Reverb
 
 	Reverb (State& stateToUse);
 
+	bool isEnabled() const;
+
 	void process (AudioBuffer& audio);
 
+	void bypass();
+
 	void prepare (double samplerate, int blocksize);
 
 	void setWidth (float width);
 
+	// in low CPU mode, the reverb runs on a mono sum of its input, at roughly half the cost. The switch is crossfaded,
+	// from a freshly cleared reverb
+	void setLowCpuMode (bool shouldUseLowCpuMode);
+
+	void requestBuffers (BufferArena<SampleType>& arena, typename BufferArena<SampleType>::Stage firstUse);
+
 private:
 
+	void updateParameters (dsp::FX::Reverb& reverbToUpdate, int dryWet);
+
+	void processWith (bool mono, AudioBuffer& audio, SampleType& level);
+
+	void processMono (AudioBuffer& audio, SampleType& level);
+
+	// runs both paths, and fades from the one being left to the other
+	void processCrossfade (AudioBuffer& audio, SampleType& level);
+
 	State&		 state;
 	ReverbState& parameters { state.parameters.reverbState };
 	Meters&		 meters { state.meters };
 
 	dsp::FX::Reverb reverb;
+	dsp::FX::Reverb monoReverb;
+
+	AudioBuffer monoBuffer, fadeBuffer;
+	AudioBuffer monoAlias, fadeAlias;
+
+	bool lowCpuMode { false };
+
+	int fadeLength { 0 };
+	int fadeSamplesRemaining { 0 };
+
+	// roughly how long the reverb takes to reach its full density from silence
+	static constexpr auto buildUpMs = 150.;
 };
 
 }  // namespace Imogen
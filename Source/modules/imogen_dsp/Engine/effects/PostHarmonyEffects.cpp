@@ -9,6 +9,9 @@ PostHarmonyEffects<SampleType>::PostHarmonyEffects (State& stateToUse)
 template <typename SampleType>
 void PostHarmonyEffects<SampleType>::prepare (double samplerate, int blocksize)
 {
+	// the worker might be running the tail stages, so it has to stop before they're prepared
+	pipeline.release();
+
 	eq.prepare (samplerate, blocksize);
 	compressor.prepare (samplerate, blocksize);
 	deEsser.prepare (samplerate, blocksize);
@@ -18,29 +21,85 @@ void PostHarmonyEffects<SampleType>::prepare (double samplerate, int blocksize)
 	reverb.prepare (samplerate, blocksize);
 	outputGain.prepare (samplerate, blocksize);
 	limiter.prepare (samplerate, blocksize);
+
+	pipeline.prepare (samplerate, blocksize);
 }
 
 template <typename SampleType>
-void PostHarmonyEffects<SampleType>::process (AudioBuffer& harmonySignal, AudioBuffer& drySignal, AudioBuffer& output)
+void PostHarmonyEffects<SampleType>::process (AudioBuffer& harmonySignal, AudioBuffer& drySignal)
 {
-	eq.process (drySignal, harmonySignal);
-	compressor.process (drySignal, harmonySignal);
-	deEsser.process (drySignal, harmonySignal);
+	// the default settings, and the same with each of the EQ and compressor switched on
+	constexpr auto eqBit		 = HeadChain::template stageBit<EQ<SampleType>>();
+	constexpr auto compressorBit = HeadChain::template stageBit<Compressor<SampleType>>();
+
+	headChain.template processSpecialized<HeadChain::allStages,
+										  HeadChain::allStages & ~eqBit,
+										  HeadChain::allStages & ~compressorBit,
+										  HeadChain::allStages & ~(eqBit | compressorBit)> (drySignal, harmonySignal);
+
+	if (pipeline.isEnabled())
+		pipeline.process (harmonySignal);
+	else
+		processTail (harmonySignal);
+}
 
-	dryWetMixer.process (drySignal, harmonySignal);
+template <typename SampleType>
+void PostHarmonyEffects<SampleType>::processTail (AudioBuffer& audio)
+{
+	// when pipelined, this is the worker thread, and the reverb is only ever touched from here
+	reverb.setWidth (static_cast<float> (stereoWidth.load (std::memory_order_relaxed)) * 0.01f);
+	reverb.setLowCpuMode (lowCpuMode.load (std::memory_order_relaxed));
 
-	delay.process (harmonySignal);
-	reverb.process (harmonySignal);
-	outputGain.process (harmonySignal);
-	limiter.process (harmonySignal);
+	// every combination of the delay and reverb toggles
+	constexpr auto delayBit	 = TailChain::template stageBit<Delay<SampleType>>();
+	constexpr auto reverbBit = TailChain::template stageBit<Reverb<SampleType>>();
 
-	dsp::buffers::copy (harmonySignal, output);
+	tailChain.template processSpecialized<TailChain::allStages,
+										  TailChain::allStages & ~delayBit,
+										  TailChain::allStages & ~reverbBit,
+										  TailChain::allStages & ~(delayBit | reverbBit)> (audio);
 }
 
 template <typename SampleType>
 void PostHarmonyEffects<SampleType>::updateStereoWidth (int width)
 {
-	reverb.setWidth (static_cast<float> (width) * 0.01f);
+	stereoWidth.store (width, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void PostHarmonyEffects<SampleType>::configure (double samplerate, bool shouldUseHighQuality)
+{
+	limiter.configure (samplerate, shouldUseHighQuality);
+}
+
+template <typename SampleType>
+int PostHarmonyEffects<SampleType>::getLatencySamples() const
+{
+	return limiter.getLatencySamples();
+}
+
+template <typename SampleType>
+void PostHarmonyEffects<SampleType>::setLowCpuMode (bool shouldUseLowCpuMode)
+{
+	lowCpuMode.store (shouldUseLowCpuMode, std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+void PostHarmonyEffects<SampleType>::setPipelined (bool shouldBePipelined)
+{
+	pipeline.setEnabled (shouldBePipelined);
+}
+
+template <typename SampleType>
+void PostHarmonyEffects<SampleType>::requestBuffers (BufferArena<SampleType>& arena)
+{
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	// when pipelined, the tail runs on the worker thread while the next block goes through the earlier stages
+	const auto firstUse = pipeline.isEnabled() ? Stage::preHarmony : Stage::postHarmony;
+
+	deEsser.requestBuffers (arena);
+	reverb.requestBuffers (arena, firstUse);
 }
 
 template class PostHarmonyEffects<float>;
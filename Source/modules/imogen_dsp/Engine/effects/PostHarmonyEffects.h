@@ -2,7 +2,18 @@
 
 #include <lemons_audio_effects/lemons_audio_effects.h>
 
+#include <imogen_dsp/Engine/Resampling/Oversampler.h>
+
+#include <imogen_dsp/Engine/BufferArena.h>
+
+#include "EffectsPipeline.h"
+#include "EffectChain.h"
+
+#include "Dynamics/DynamicsProcessor.h"
+#include "Dynamics/LookaheadLimiter.h"
+
 #include "PreHarmony/StereoReducer.h"
+#include "PreHarmony/LoCutFilter.h"
 #include "PreHarmony/InputGain.h"
 #include "PreHarmony/NoiseGate.h"
 
@@ -28,12 +39,29 @@ public:
 
 	void prepare (double samplerate, int blocksize);
 
-	void process (AudioBuffer& harmonySignal, AudioBuffer& drySignal, AudioBuffer& output);
+	// the harmony signal is processed in place, and becomes the engine's output
+	void process (AudioBuffer& harmonySignal, AudioBuffer& drySignal);
 
+	// these two are passed on by whichever thread runs the reverb, at the start of its next chunk
 	void updateStereoWidth (int width);
+	void setLowCpuMode (bool shouldUseLowCpuMode);
+
+	// call before prepare(), as it changes the latency
+	void configure (double samplerate, bool shouldUseHighQuality);
+
+	// not counting the pipeline's
+	int getLatencySamples() const;
+
+	// runs the delay, reverb and the rest of the chain after them on a worker thread, one chunk behind, which adds a
+	// chunk of latency. Call before prepare()
+	void setPipelined (bool shouldBePipelined);
+
+	void requestBuffers (BufferArena<SampleType>& arena);
 
 private:
 
+	void processTail (AudioBuffer& audio);
+
 	State&		state;
 	Parameters& parameters { state.parameters };
 
@@ -46,6 +74,18 @@ private:
 	Reverb<SampleType>		reverb { state };
 	OutputGain<SampleType>	outputGain { parameters };
 	Limiter<SampleType>		limiter { state };
+
+	using HeadChain = EffectChain<EQ<SampleType>, Compressor<SampleType>, DeEsser<SampleType>, DryWetMixer<SampleType>>;
+	using TailChain = EffectChain<Delay<SampleType>, Reverb<SampleType>, OutputGain<SampleType>, Limiter<SampleType>>;
+
+	HeadChain headChain { eq, compressor, deEsser, dryWetMixer };
+	TailChain tailChain { delay, reverb, outputGain, limiter };
+
+	std::atomic<int>  stereoWidth { 100 };
+	std::atomic<bool> lowCpuMode { false };
+
+	EffectsPipeline<SampleType> pipeline { [this] (AudioBuffer& audio)
+										   { processTail (audio); } };
 };
 
 }  // namespace Imogen
@@ -9,16 +9,71 @@ InputGain<SampleType>::InputGain (State& stateToUse) : state (stateToUse)
 template <typename SampleType>
 void InputGain<SampleType>::process (AudioBuffer& audio)
 {
-	gain.setGain (parameters.inputGain->get());
-	gain.process (audio);
+	jassert (audio.getNumChannels() == 1);
 
-	meters.inputLevel->set (static_cast<float> (audio.getRMSLevel (0, 0, audio.getNumSamples())));
+	const auto numSamples = audio.getNumSamples();
+	auto*	   samples	  = audio.getWritePointer (0);
+
+	startBlock();
+
+	auto sumOfSquares = 0.;
+
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		const auto sample = samples[i] * getNextGain();
+
+		samples[i] = sample;
+		sumOfSquares += sample * sample;
+	}
+
+	finishBlock (sumOfSquares, numSamples);
+}
+
+template <typename SampleType>
+void InputGain<SampleType>::startBlock()
+{
+	const auto newTarget = juce::Decibels::decibelsToGain (static_cast<SampleType> (parameters.inputGain->get()));
+
+	if (newTarget == targetGain)
+		return;
+
+	targetGain	   = newTarget;
+	stepsRemaining = rampLength;
+	step		   = (targetGain - currentGain) / static_cast<SampleType> (rampLength);
+}
+
+template <typename SampleType>
+SampleType InputGain<SampleType>::getNextGain() noexcept
+{
+	if (stepsRemaining == 0)
+		return currentGain;
+
+	// land exactly on the target, whatever rounding the steps picked up
+	currentGain = --stepsRemaining == 0 ? targetGain : currentGain + step;
+
+	return currentGain;
+}
+
+template <typename SampleType>
+void InputGain<SampleType>::finishBlock (double sumOfSquares, int numSamples)
+{
+	if (! publishesMeters)
+		return;
+
+	const auto rms = numSamples > 0 ? std::sqrt (sumOfSquares / numSamples) : 0.;
+
+	meters.inputLevel->set (static_cast<float> (rms));
 }
 
 template <typename SampleType>
-void InputGain<SampleType>::prepare (double samplerate, int blocksize)
+void InputGain<SampleType>::prepare (double samplerate, int)
 {
-	gain.prepare (samplerate, blocksize);
+	rampLength = std::max (1, juce::roundToInt (samplerate * rampMs * 0.001));
+
+	// start at the current setting rather than ramping up to it
+	currentGain	   = juce::Decibels::decibelsToGain (static_cast<SampleType> (parameters.inputGain->get()));
+	targetGain	   = currentGain;
+	stepsRemaining = 0;
 }
 
 template struct InputGain<float>;
@@ -1,4 +1,3 @@
-
 #pragma once
 
 namespace Imogen
@@ -14,13 +13,31 @@ struct InputGain
 
 	void prepare (double samplerate, int blocksize);
 
+	// the same processing one sample at a time, for the fused input stage:
+	// call startBlock(), then getNextGain() for each sample, then finishBlock() with the sum of the squared output
+	void startBlock();
+
+	SampleType getNextGain() noexcept;
+
+	void finishBlock (double sumOfSquares, int numSamples);
+
+	void setPublishesMeters (bool shouldPublish) noexcept { publishesMeters = shouldPublish; }
+
 private:
 
 	State&		state;
 	Parameters& parameters { state.parameters };
 	Meters&		meters { state.meters };
 
-	dsp::FX::SmoothedGain<SampleType, 1> gain;
+	// the gain ramps linearly to each new target over this long
+	static constexpr auto rampMs = 50.;
+
+	int rampLength { 1 };
+
+	SampleType currentGain { 1 }, targetGain { 1 }, step { 0 };
+	int		   stepsRemaining { 0 };
+
+	bool publishesMeters { true };
 };
 
 }  // namespace Imogen
@@ -0,0 +1,60 @@
+
+namespace Imogen
+{
+template <typename SampleType>
+LoCutFilter<SampleType>::LoCutFilter (float cutoffHz)
+	: cutoff (cutoffHz)
+{
+}
+
+template <typename SampleType>
+void LoCutFilter<SampleType>::prepare (double samplerate, int)
+{
+	// bilinear transform of the analog prototype, with Q = 1 / sqrt(2)
+	const auto w0	 = juce::MathConstants<double>::twoPi * static_cast<double> (cutoff) / samplerate;
+	const auto alpha = std::sin (w0) / juce::MathConstants<double>::sqrt2;
+	const auto cosw0 = std::cos (w0);
+	const auto a0	 = 1. + alpha;
+
+	b0 = static_cast<SampleType> ((1. + cosw0) * 0.5 / a0);
+	b1 = static_cast<SampleType> (-(1. + cosw0) / a0);
+	b2 = b0;
+	a1 = static_cast<SampleType> (-2. * cosw0 / a0);
+	a2 = static_cast<SampleType> ((1. - alpha) / a0);
+
+	reset();
+}
+
+template <typename SampleType>
+void LoCutFilter<SampleType>::reset()
+{
+	z1 = 0;
+	z2 = 0;
+}
+
+template <typename SampleType>
+SampleType LoCutFilter<SampleType>::processSample (SampleType input) noexcept
+{
+	const auto output = b0 * input + z1;
+
+	z1 = b1 * input - a1 * output + z2;
+	z2 = b2 * input - a2 * output;
+
+	return output;
+}
+
+template <typename SampleType>
+void LoCutFilter<SampleType>::process (AudioBuffer& audio)
+{
+	jassert (audio.getNumChannels() == 1);
+
+	auto* samples = audio.getWritePointer (0);
+
+	for (auto i = 0; i < audio.getNumSamples(); ++i)
+		samples[i] = processSample (samples[i]);
+}
+
+template class LoCutFilter<float>;
+template class LoCutFilter<double>;
+
+}  // namespace Imogen
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace Imogen
+{
+/*
+	A second-order Butterworth high-pass that takes the rumble out of the input before it's analyzed.
+	It has a per-sample interface so that the fused input stage can run it inside its own loop.
+*/
+template <typename SampleType>
+class LoCutFilter
+{
+public:
+
+	using AudioBuffer = juce::AudioBuffer<SampleType>;
+
+	explicit LoCutFilter (float cutoffHz);
+
+	void prepare (double samplerate, int blocksize);
+
+	void reset();
+
+	void process (AudioBuffer& audio);
+
+	SampleType processSample (SampleType input) noexcept;
+
+private:
+
+	float cutoff;
+
+	SampleType b0 { 1 }, b1 { 0 }, b2 { 0 }, a1 { 0 }, a2 { 0 };
+
+	// transposed direct form II state
+	SampleType z1 { 0 }, z2 { 0 };
+};
+
+}  // namespace Imogen
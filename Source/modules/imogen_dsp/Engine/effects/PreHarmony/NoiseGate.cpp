@@ -4,26 +4,55 @@ namespace Imogen
 template <typename SampleType>
 NoiseGate<SampleType>::NoiseGate (State& stateToUse) : state (stateToUse)
 {
-	//    static constexpr auto noiseGateAttackMs   = 25.0f;
-	//    static constexpr auto noiseGateReleaseMs  = 100.0f;
-	//    static constexpr auto noiseGateFloorRatio = 10.0f;  // ratio to one when the noise gate is activated
+	gate.setType (DynamicsProcessor<SampleType>::Type::expander);
+	gate.setRatio (SampleType (ratio));
+	gate.setKnee (SampleType (kneeDb));
+	gate.setAttackMs (attackMs);
+	gate.setReleaseMs (releaseMs);
+}
+
+template <typename SampleType>
+bool NoiseGate<SampleType>::isEnabled() const
+{
+	return parameters.noiseGateToggle->get();
 }
 
 template <typename SampleType>
 void NoiseGate<SampleType>::process (AudioBuffer& audio)
 {
-	if (parameters.noiseGateToggle->get())
-	{
-		gate.setThreshold (parameters.noiseGateThresh->get());
+	gate.setThreshold (static_cast<SampleType> (parameters.noiseGateThresh->get()));
+
+	gate.process (audio);
 
-		gate.process (audio);
+	updateMeter (Meters::toReduction (gate.getAverageGainReduction()));
+}
 
-		meters.gateRedux->set (static_cast<float> (gate.getAverageGainReduction()));
-	}
-	else
-	{
-		meters.gateRedux->set (0.f);
-	}
+template <typename SampleType>
+void NoiseGate<SampleType>::startBlock()
+{
+	gate.setThreshold (static_cast<SampleType> (parameters.noiseGateThresh->get()));
+	gate.startBlock();
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::finishBlock (int numSamples)
+{
+	gate.finishBlock (numSamples);
+
+	updateMeter (Meters::toReduction (gate.getAverageGainReduction()));
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::bypass()
+{
+	updateMeter (0.f);
+}
+
+template <typename SampleType>
+void NoiseGate<SampleType>::updateMeter (float reduction)
+{
+	if (publishesMeters)
+		meters.gateRedux->set (reduction);
 }
 
 template <typename SampleType>
@@ -9,17 +9,39 @@ struct NoiseGate
 
 	NoiseGate (State& stateToUse);
 
+	bool isEnabled() const;
+
 	void process (AudioBuffer& audio);
 
+	void bypass();
+
 	void prepare (double samplerate, int blocksize);
 
+	// the same processing one sample at a time, for the fused input stage:
+	// call startBlock(), then getGain() for each sample, then finishBlock()
+	void	   startBlock();
+	SampleType getGain (SampleType input) noexcept { return gate.processSample (std::abs (input)); }
+	void	   finishBlock (int numSamples);
+
+	void setPublishesMeters (bool shouldPublish) noexcept { publishesMeters = shouldPublish; }
+
 private:
 
+	void updateMeter (float reduction);
+
+
 	State&		state;
 	Parameters& parameters { state.parameters };
 	Meters&		meters { state.meters };
 
-	dsp::FX::NoiseGate<SampleType> gate;
+	DynamicsProcessor<SampleType> gate;
+
+	bool publishesMeters { true };
+
+	static constexpr auto attackMs	= 25.f;
+	static constexpr auto releaseMs = 100.f;
+	static constexpr auto ratio		= 10;  // ratio to one when the noise gate is activated
+	static constexpr auto kneeDb	= 6;
 };
 
 }  // namespace Imogen
@@ -6,25 +6,40 @@ StereoReducer<SampleType>::StereoReducer (Parameters& params) : parameters (para
 {
 }
 
+template <typename SampleType>
+int StereoReducer<SampleType>::getSourceChannel (const AudioBuffer& stereoInput) const
+{
+	const auto mode = parameters.inputMode->get();
+
+	if (mode == 3 && stereoInput.getNumChannels() > 1)
+		return -1;
+
+	return std::min (mode == 2 ? 1 : 0, stereoInput.getNumChannels() - 1);
+}
+
 template <typename SampleType>
 void StereoReducer<SampleType>::process (const AudioBuffer& stereoInput, AudioBuffer& monoOutput)
 {
-	using Mode = typename dsp::FX::MonoStereoConverter<SampleType>::StereoReductionMode;
+	const auto numSamples = stereoInput.getNumSamples();
 
-	switch (parameters.inputMode->get())
+	// the later input stages work in place and the input is read-only, so this one copy can't be elided
+	if (const auto channel = getSourceChannel (stereoInput); channel >= 0)
 	{
-		case (1) : reducer.setStereoReductionMode (Mode::rightOnly); break;
-		case (2) : reducer.setStereoReductionMode (Mode::mixToMono); break;
-		default : reducer.setStereoReductionMode (Mode::leftOnly); break;
+		monoOutput.copyFrom (0, 0, stereoInput, channel, 0, numSamples);
+		return;
 	}
 
-	reducer.convertStereoToMono (stereoInput, monoOutput);
+	const auto* left  = stereoInput.getReadPointer (0);
+	const auto* right = stereoInput.getReadPointer (1);
+	auto*		mono  = monoOutput.getWritePointer (0);
+
+	for (auto i = 0; i < numSamples; ++i)
+		mono[i] = mix (left[i], right[i]);
 }
 
 template <typename SampleType>
-void StereoReducer<SampleType>::prepare (double, int blocksize)
+void StereoReducer<SampleType>::prepare (double, int)
 {
-	reducer.prepare (blocksize);
 }
 
 template struct StereoReducer<float>;
@@ -13,11 +13,14 @@ struct StereoReducer
 
 	void prepare (double samplerate, int blocksize);
 
+	// the input channel to take, or -1 to mix both channels down
+	int getSourceChannel (const AudioBuffer& stereoInput) const;
+
+	static SampleType mix (SampleType left, SampleType right) noexcept { return (left + right) * SampleType (0.5); }
+
 private:
 
 	Parameters& parameters;
-
-	dsp::FX::MonoStereoConverter<SampleType> reducer;
 };
 
 }  // namespace Imogen
@@ -10,8 +10,6 @@ PreHarmonyEffects<SampleType>::PreHarmonyEffects (State& stateToUse)
 template <typename SampleType>
 void PreHarmonyEffects<SampleType>::prepare (double samplerate, int blocksize)
 {
-	processedMonoBuffer.setSize (1, blocksize, true, true, true);
-
 	stereoReducer.prepare (samplerate, blocksize);
 	initialLoCut.prepare (samplerate, blocksize);
 	inputGain.prepare (samplerate, blocksize);
@@ -21,10 +19,96 @@ void PreHarmonyEffects<SampleType>::prepare (double samplerate, int blocksize)
 template <typename SampleType>
 void PreHarmonyEffects<SampleType>::process (const AudioBuffer& input)
 {
+	// with every stage active, they all run in a single pass over the block
+	if (inputChain.getEnabledStages() == InputChain::allStages)
+	{
+		processFused (input);
+		return;
+	}
+
 	stereoReducer.process (input, processedMonoBuffer);
-	initialLoCut.process (processedMonoBuffer);
-	inputGain.process (processedMonoBuffer);
-	gate.process (processedMonoBuffer);
+
+	constexpr auto gateOff = InputChain::allStages & ~InputChain::template stageBit<NoiseGate<SampleType>>();
+
+	inputChain.template processSpecialized<gateOff> (processedMonoBuffer);
+}
+
+template <typename SampleType>
+void PreHarmonyEffects<SampleType>::setPublishesMeters (bool shouldPublish) noexcept
+{
+	inputGain.setPublishesMeters (shouldPublish);
+	gate.setPublishesMeters (shouldPublish);
+}
+
+template <typename SampleType>
+void PreHarmonyEffects<SampleType>::skip (const SampleType* source, int numSamples)
+{
+	auto sumOfSquares = 0.;
+
+	for (auto i = 0; i < numSamples; ++i)
+		sumOfSquares += static_cast<double> (source[i]) * static_cast<double> (source[i]);
+
+	inputGain.finishBlock (sumOfSquares, numSamples);
+	gate.bypass();
+}
+
+template <typename SampleType>
+void PreHarmonyEffects<SampleType>::processFused (const AudioBuffer& input)
+{
+	const auto numSamples = input.getNumSamples();
+
+	if (const auto channel = stereoReducer.getSourceChannel (input); channel >= 0)
+	{
+		const auto* source = input.getReadPointer (channel);
+
+		processFused ([source] (int i)
+					  { return source[i]; },
+					  numSamples);
+	}
+	else
+	{
+		const auto* left  = input.getReadPointer (0);
+		const auto* right = input.getReadPointer (1);
+
+		processFused ([left, right] (int i)
+					  { return StereoReducer<SampleType>::mix (left[i], right[i]); },
+					  numSamples);
+	}
+}
+
+template <typename SampleType>
+template <typename ReadSample>
+void PreHarmonyEffects<SampleType>::processFused (ReadSample&& readSample, int numSamples)
+{
+	// the same steps, in the same order, as the separate stages, so the results are identical
+	auto* output = processedMonoBuffer.getWritePointer (0);
+
+	inputGain.startBlock();
+	gate.startBlock();
+
+	auto sumOfSquares = 0.;
+
+	for (auto i = 0; i < numSamples; ++i)
+	{
+		const auto filtered = initialLoCut.processSample (readSample (i));
+		const auto gained	= filtered * inputGain.getNextGain();
+
+		sumOfSquares += gained * gained;
+
+		output[i] = gained * gate.getGain (gained);
+	}
+
+	inputGain.finishBlock (sumOfSquares, numSamples);
+	gate.finishBlock (numSamples);
+}
+
+template <typename SampleType>
+void PreHarmonyEffects<SampleType>::requestBuffers (BufferArena<SampleType>& arena)
+{
+	using Stage = typename BufferArena<SampleType>::Stage;
+
+	// the shifters read the analyzed input while the harmony and lead are rendered
+	arena.request (processedMonoBuffer, 1, Stage::preHarmony, Stage::lead);
 }
 
 template <typename SampleType>
@@ -15,18 +15,36 @@ public:
 
 	void process (const AudioBuffer& input);
 
+	// for when the analysis reads a dedicated source instead, and these stages don't run. The input meter then follows
+	// that source, and the gate meter shows no reduction
+	void skip (const SampleType* source, int numSamples);
+
 	const SampleType* getProcessedInputSignal() const;
 
+	void requestBuffers (BufferArena<SampleType>& arena);
+
+	// with several singers, only one of them drives the input meters
+	void setPublishesMeters (bool shouldPublish) noexcept;
+
 private:
 
+	void processFused (const AudioBuffer& input);
+
+	template <typename ReadSample>
+	void processFused (ReadSample&& readSample, int numSamples);
+
 	AudioBuffer processedMonoBuffer;
 
 	State& state;
 
 	StereoReducer<SampleType>	stereoReducer { state.parameters };
-	dsp::FX::Filter<SampleType> initialLoCut { dsp::FX::FilterType::HighPass, 65.f };
+	LoCutFilter<SampleType>		initialLoCut { 65.f };
 	InputGain<SampleType>		inputGain { state };
 	NoiseGate<SampleType>		gate { state };
+
+	using InputChain = EffectChain<LoCutFilter<SampleType>, InputGain<SampleType>, NoiseGate<SampleType>>;
+
+	InputChain inputChain { initialLoCut, inputGain, gate };
 };
 
 }  // namespace Imogen
@@ -7,6 +7,17 @@ Processor::Processor()
 											.withInput (TRANS ("Sidechain"), juce::AudioChannelSet::mono(), false)
 											.withOutput (TRANS ("Output"), juce::AudioChannelSet::stereo(), true))
 {
+	startTimer (tuningPollIntervalMs);
+}
+
+Processor::~Processor()
+{
+	stopTimer();
+}
+
+void Processor::timerCallback()
+{
+	getState().internals.pollTuning();
 }
 
 double Processor::getTailLengthSeconds() const
@@ -14,6 +25,70 @@ double Processor::getTailLengthSeconds() const
 	return parameters.midiState.adsrRelease->get();
 }
 
+void Processor::setNonRealtime (bool isNonRealtime) noexcept
+{
+	plugin::Processor<State, Engine>::setNonRealtime (isNonRealtime);
+
+	// the engines pick this up on the next prepare, which hosts make before they start an offline render
+	getState().internals.isNonRealtime.store (isNonRealtime);
+}
+
+void Processor::processorLayoutsChanged()
+{
+	plugin::Processor<State, Engine>::processorLayoutsChanged();
+
+	auto channel = -1;
+
+	if (const auto* sidechain = getBus (true, 1); sidechain != nullptr && sidechain->isEnabled())
+		channel = getChannelIndexInProcessBlockBuffer (true, 1, 0);
+
+	// the engines read this on every block, so a layout change takes effect straight away
+	getState().internals.sidechainChannel.store (channel);
+}
+
+void Processor::prepareToPlay (double samplerate, int samplesPerBlock)
+{
+	plugin::Processor<State, Engine>::prepareToPlay (samplerate, samplesPerBlock);
+
+	// the whole delay the engine was just prepared with, not only the chunk the base class reported
+	setLatencySamples (getState().internals.latencySamples.load());
+
+	floatMonitor.prepare (samplerate, samplesPerBlock);
+	doubleMonitor.prepare (samplerate, samplesPerBlock);
+}
+
+void Processor::processBlock (juce::AudioBuffer<float>& audio, MidiBuffer& midiMessages)
+{
+	processWithMonitoring (audio, midiMessages, floatMonitor);
+}
+
+void Processor::processBlock (juce::AudioBuffer<double>& audio, MidiBuffer& midiMessages)
+{
+	processWithMonitoring (audio, midiMessages, doubleMonitor);
+}
+
+template <typename SampleType>
+void Processor::processWithMonitoring (juce::AudioBuffer<SampleType>& audio, MidiBuffer& midiMessages, DryMonitor<SampleType>& monitor)
+{
+	// the engine's load governor measures its render time against this
+	getState().internals.hostBlocksize.store (audio.getNumSamples(), std::memory_order_relaxed);
+
+	// the monitored lead can't be delay compensated, so during playback the engine renders the lead instead
+	auto isPlaying = false;
+
+	if (auto* playHead = getPlayHead())
+		if (const auto position = playHead->getPosition())
+			isPlaying = position->getIsPlaying();
+
+	// the engine writes its output over the input, so the input has to be taken first
+	monitor.capture (getBusBuffer (audio, true, 0), isPlaying);
+
+	plugin::Processor<State, Engine>::processBlock (audio, midiMessages);
+
+	auto output = getBusBuffer (audio, false, 0);
+	monitor.addTo (output);
+}
+
 bool Processor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
 	if (layouts.getMainInputChannelSet().isDisabled() && layouts.getChannelSet (true, 1).isDisabled()) return false;
@@ -2,15 +2,18 @@
 #pragma once
 
 #include <imogen_dsp/Engine/Engine.h>
+#include <imogen_dsp/Engine/Lead/DryMonitor.h>
 
 namespace Imogen
 {
-class Processor : public plugin::Processor<State, Engine>
+class Processor : public plugin::Processor<State, Engine>, private juce::Timer
 {
 public:
 
 	Processor();
 
+	~Processor() override;
+
 private:
 
 	bool canAddBus (bool isInput) const override final { return isInput; }
@@ -18,6 +21,21 @@ private:
 
 	double getTailLengthSeconds() const final;
 
+	void setNonRealtime (bool isNonRealtime) noexcept final;
+
+	void processorLayoutsChanged() final;
+
+	void timerCallback() final;
+
+	void prepareToPlay (double samplerate, int samplesPerBlock) final;
+
+	void processBlock (juce::AudioBuffer<float>& audio, MidiBuffer& midiMessages) final;
+	void processBlock (juce::AudioBuffer<double>& audio, MidiBuffer& midiMessages) final;
+
+	// the engine delays everything it renders, so the zero-latency lead has to go around it
+	template <typename SampleType>
+	void processWithMonitoring (juce::AudioBuffer<SampleType>& audio, MidiBuffer& midiMessages, DryMonitor<SampleType>& monitor);
+
 	bool acceptsMidi() const final { return true; }
 	bool producesMidi() const final { return true; }
 	bool supportsMPE() const final { return false; }
@@ -28,6 +46,12 @@ private:
 
 	Parameters& parameters { getState().parameters };
 
+	// how often the MTS-ESP connection and scale are checked
+	static constexpr auto tuningPollIntervalMs = 250;
+
+	DryMonitor<float>  floatMonitor { getState() };
+	DryMonitor<double> doubleMonitor { getState() };
+
 	// network::OscDataSynchronizer dataSync {state};
 };
 
@@ -0,0 +1,63 @@
+namespace Imogen
+{
+/*
+	Reports what each voice range costs: the analyzer's latency, and the time it takes to analyze the same input. A
+	higher range must never have a longer window than a lower one.
+*/
+
+class AnalysisWindowTests : public juce::UnitTest
+{
+public:
+
+	AnalysisWindowTests()
+		: juce::UnitTest ("Analysis window per voice range", "Imogen")
+	{
+	}
+
+	void runTest() final
+	{
+		beginTest ("Higher voice ranges have shorter windows");
+
+		const auto input = makeTestSignal (numSamples);
+
+		auto lastLatency = std::numeric_limits<int>::max();
+
+		for (auto range = 0; range < static_cast<int> (std::size (EngineState::voiceRangeFloorsHz)); ++range)
+		{
+			const auto lowestPitch = EngineState::getLowestPitchHz (range);
+
+			dsp::psola::Analyzer<double> analyzer;
+			analyzer.setMinInputFreq (lowestPitch);
+			analyzer.prepare (samplerate, maxBlocksize);
+
+			const auto latency = analyzer.getLatencySamples();
+
+			// fed in chunks of its own latency, as the engine does
+			const auto chunkSize = juce::jlimit (1, maxBlocksize, latency);
+
+			const auto startTicks = juce::Time::getHighResolutionTicks();
+
+			for (auto start = 0; start + chunkSize <= numSamples; start += chunkSize)
+				analyzer.analyzeInput (input.data() + start, chunkSize);
+
+			const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+			logMessage (juce::String (lowestPitch) + " Hz floor: " + juce::String (latency) + " samples ("
+						+ juce::String (latency * 1000. / samplerate, 1) + " ms) latency, "
+						+ juce::String (seconds * 1000., 2) + " ms to analyze one second");
+
+			expectLessOrEqual (latency, lastLatency);
+			lastLatency = latency;
+		}
+	}
+
+private:
+
+	static constexpr auto samplerate   = 48000.;
+	static constexpr auto numSamples   = 48000;
+	static constexpr auto maxBlocksize = 4096;
+};
+
+static AnalysisWindowTests analysisWindowTests;
+
+}  // namespace Imogen
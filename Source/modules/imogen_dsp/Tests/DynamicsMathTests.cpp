@@ -0,0 +1,98 @@
+namespace Imogen
+{
+/*
+	Checks the fast dB conversions against the exact std functions, over the whole range the dynamics processors use.
+*/
+
+class DynamicsMathTests : public juce::UnitTest
+{
+public:
+
+	DynamicsMathTests()
+		: juce::UnitTest ("Dynamics math accuracy", "Imogen")
+	{
+	}
+
+	void runTest() final
+	{
+		beginTest ("fastLog2 matches std::log2");
+		{
+			auto maxError = 0.;
+
+			for (auto i = 0; i <= numSteps; ++i)
+			{
+				const auto x = std::exp2 (minOctaves + (maxOctaves - minOctaves) * i / static_cast<double> (numSteps));
+
+				maxError = std::max (maxError, std::abs (DynamicsMath::fastLog2 (static_cast<float> (x)) - std::log2 (static_cast<double> (static_cast<float> (x)))));
+			}
+
+			expectLessThan (maxError, 3.e-6);
+		}
+
+		beginTest ("fastExp2 matches std::exp2");
+		{
+			auto maxError = 0.;
+
+			for (auto i = 0; i <= numSteps; ++i)
+			{
+				const auto x = static_cast<float> (minOctaves + (maxOctaves - minOctaves) * i / static_cast<double> (numSteps));
+
+				const auto exact = std::exp2 (static_cast<double> (x));
+
+				maxError = std::max (maxError, std::abs (DynamicsMath::fastExp2 (x) - exact) / exact);
+			}
+
+			expectLessThan (maxError, 3.e-7);
+		}
+
+		beginTest ("Block conversions round trip");
+		{
+			std::vector<float>	floats (numSteps);
+			std::vector<double> doubles (numSteps);
+
+			for (auto i = 0; i < numSteps; ++i)
+			{
+				const auto db = DynamicsMath::minusInfinityDb * (1. - i / static_cast<double> (numSteps)) + 12. * i / static_cast<double> (numSteps);
+
+				floats[static_cast<size_t> (i)]	 = static_cast<float> (db);
+				doubles[static_cast<size_t> (i)] = db;
+			}
+
+			const auto expected = doubles;
+
+			DynamicsMath::decibelsToGain (floats.data(), floats.data(), numSteps);
+			DynamicsMath::gainToDecibels (floats.data(), floats.data(), numSteps);
+
+			DynamicsMath::decibelsToGain (doubles.data(), doubles.data(), numSteps);
+			DynamicsMath::gainToDecibels (doubles.data(), doubles.data(), numSteps);
+
+			auto floatError	 = 0.;
+			auto doubleError = 0.;
+
+			for (auto i = 0; i < numSteps; ++i)
+			{
+				floatError	= std::max (floatError, std::abs (floats[static_cast<size_t> (i)] - expected[static_cast<size_t> (i)]));
+				doubleError = std::max (doubleError, std::abs (doubles[static_cast<size_t> (i)] - expected[static_cast<size_t> (i)]));
+			}
+
+			expectLessThan (floatError, 1.e-4);
+			expectLessThan (doubleError, 1.e-9);
+		}
+
+		beginTest ("Silence is floored at minusInfinityDb");
+		{
+			expectWithinAbsoluteError (DynamicsMath::gainToDecibels (0.f), DynamicsMath::minusInfinityDb, 1.e-3f);
+			expectWithinAbsoluteError (DynamicsMath::gainToDecibels (0.), static_cast<double> (DynamicsMath::minusInfinityDb), 1.e-9);
+		}
+	}
+
+private:
+
+	static constexpr auto numSteps	 = 4096;
+	static constexpr auto minOctaves = -20.;
+	static constexpr auto maxOctaves = 4.;
+};
+
+static DynamicsMathTests dynamicsMathTests;
+
+}  // namespace Imogen
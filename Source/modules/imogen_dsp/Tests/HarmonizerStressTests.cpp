@@ -0,0 +1,121 @@
+namespace Imogen
+{
+/*
+	Sends dense bursts of MIDI through the harmonizer, and reports the worst block time against the average. However
+	many events arrive, a block must never be split into more sub-blocks than Harmonizer::getMaxSubBlocks() allows.
+*/
+
+class HarmonizerStressTests : public juce::UnitTest
+{
+public:
+
+	HarmonizerStressTests()
+		: juce::UnitTest ("Harmonizer MIDI stress", "Imogen")
+	{
+	}
+
+	void runTest() final
+	{
+		beginTest ("Sparse notes");
+		runBurst ([] (MidiBuffer& midi, int block)
+				  {
+					  midi.addEvent (juce::MidiMessage::noteOn (1, 60 + block % 12, 0.8f), 0);
+					  midi.addEvent (juce::MidiMessage::noteOff (1, 60 + (block + 11) % 12), blocksize / 2);
+				  });
+
+		beginTest ("Glissando, a note every sample");
+		runBurst ([] (MidiBuffer& midi, int block)
+				  {
+					  for (auto i = 0; i < blocksize; ++i)
+					  {
+						  const auto note = 36 + (block * blocksize + i) % 60;
+
+						  midi.addEvent (juce::MidiMessage::noteOff (1, note == 36 ? 95 : note - 1), i);
+						  midi.addEvent (juce::MidiMessage::noteOn (1, note, 0.8f), i);
+					  }
+				  });
+
+		beginTest ("Chord spam, a new chord every 3 samples");
+		runBurst ([] (MidiBuffer& midi, int block)
+				  {
+					  for (auto i = 0; i < blocksize; i += 3)
+					  {
+						  const auto root = 48 + (block + i) % 24;
+
+						  for (const auto interval : { 0, 4, 7, 11, 14, 17 })
+						  {
+							  midi.addEvent (juce::MidiMessage::noteOff (1, root + interval - 1), i);
+							  midi.addEvent (juce::MidiMessage::noteOn (1, root + interval, 0.8f), i);
+						  }
+					  }
+				  });
+	}
+
+private:
+
+	template <typename MakeMidi>
+	void runBurst (MakeMidi&& makeMidi)
+	{
+		State state;
+
+		dsp::psola::Analyzer<double> analyzer;
+		VoicingDetector<double>		 voicing { state.internals };
+		Harmonizer<double>			 harmonizer { state, analyzer, voicing };
+
+		voicing.setPublishesInternals (false);
+		harmonizer.setPublishesInternals (false);
+
+		analyzer.prepare (samplerate, blocksize);
+		voicing.prepare (samplerate);
+		harmonizer.initialize (numVoices, samplerate, blocksize);
+		harmonizer.prepare (samplerate, blocksize);
+
+		const auto input = makeTestSignal (blocksize * numBlocks);
+
+		juce::AudioBuffer<double> output (2, blocksize);
+		MidiBuffer				  midi;
+
+		auto maxSubBlocks = 0;
+		auto worstSeconds = 0.;
+		auto totalSeconds = 0.;
+
+		for (auto block = 0; block < numBlocks; ++block)
+		{
+			const auto* samples = input.data() + block * blocksize;
+
+			analyzer.analyzeInput (samples, blocksize);
+			voicing.analyze (samples, blocksize);
+
+			midi.clear();
+			makeMidi (midi, block);
+
+			const auto firstPass  = harmonizer.getRenderPass();
+			const auto startTicks = juce::Time::getHighResolutionTicks();
+
+			harmonizer.process (output, midi, false);
+
+			const auto seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+			worstSeconds = std::max (worstSeconds, seconds);
+			totalSeconds += seconds;
+
+			maxSubBlocks = std::max (maxSubBlocks, static_cast<int> (harmonizer.getRenderPass() - firstPass));
+		}
+
+		logMessage ("worst block " + juce::String (worstSeconds * 1000., 3) + " ms, average "
+					+ juce::String (totalSeconds * 1000. / numBlocks, 3) + " ms, of "
+					+ juce::String (blocksize * 1000. / samplerate, 3) + " ms available; at most "
+					+ juce::String (maxSubBlocks) + " sub-blocks");
+
+		expectLessOrEqual (maxSubBlocks, Harmonizer<double>::getMaxSubBlocks (blocksize));
+	}
+
+	static constexpr auto samplerate = 48000.;
+	static constexpr auto blocksize	 = 512;
+	static constexpr auto numBlocks	 = 64;
+	static constexpr auto numVoices	 = 16;
+};
+
+static HarmonizerStressTests harmonizerStressTests;
+
+}  // namespace Imogen
@@ -0,0 +1,191 @@
+
+namespace Imogen
+{
+/*
+	Checks that the delay each stage reports is the delay a signal actually sees through it, since the engine adds
+	these figures up for the host's delay compensation.
+*/
+
+// the lag (up to maxLag) at which output best matches input, skipping the first settleSamples of output
+static int measureDelay (const std::vector<double>& input, const std::vector<double>& output, int maxLag, int settleSamples)
+{
+	auto bestLag   = 0;
+	auto bestError = std::numeric_limits<double>::max();
+
+	for (auto lag = 0; lag <= maxLag; ++lag)
+	{
+		auto error = 0.;
+
+		for (auto i = std::max (settleSamples, lag); i < static_cast<int> (output.size()); ++i)
+		{
+			const auto diff = output[static_cast<size_t> (i)] - input[static_cast<size_t> (i - lag)];
+			error += diff * diff;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			bestLag	  = lag;
+		}
+	}
+
+	return bestLag;
+}
+
+// a signal well inside the passband of every resampling stage
+static std::vector<double> makeTestSignal (int numSamples)
+{
+	std::vector<double> signal (static_cast<size_t> (numSamples));
+
+	for (auto i = 0; i < numSamples; ++i)
+		signal[static_cast<size_t> (i)] = 0.5 * std::sin (juce::MathConstants<double>::twoPi * 0.011 * i)
+										+ 0.25 * std::sin (juce::MathConstants<double>::twoPi * 0.003 * i);
+
+	return signal;
+}
+
+
+class ResamplerLatencyTests : public juce::UnitTest
+{
+public:
+
+	ResamplerLatencyTests()
+		: juce::UnitTest ("Harmony resampler latency", "Imogen")
+	{
+	}
+
+	void runTest() final
+	{
+		beginTest ("Disabled resampler reports no delay");
+		{
+			HarmonyResampler<double> resampler;
+			resampler.setNumStages (0);
+
+			expect (! resampler.isEnabled());
+			expectEquals (resampler.getLatencySamples(), 0);
+		}
+
+		for (auto stages = 1; stages <= 2; ++stages)
+		{
+			beginTest ("Round trip delay matches the reported latency with " + juce::String (stages) + " stages");
+
+			HarmonyResampler<double> resampler;
+			BufferArena<double>		 arena;
+
+			resampler.setNumStages (stages);
+			resampler.prepare (blocksize);
+			resampler.requestBuffers (arena);
+			arena.allocate (blocksize);
+
+			const auto input = makeTestSignal (numSamples);
+
+			std::vector<double> harmonyOut (static_cast<size_t> (numSamples));
+			std::vector<double> leadOut (static_cast<size_t> (numSamples));
+
+			juce::AudioBuffer<double> output (2, blocksize);
+
+			const auto reducedSize = blocksize / resampler.getFactor();
+
+			juce::AudioBuffer<double> lead (2, reducedSize);
+
+			for (auto start = 0; start < numSamples; start += blocksize)
+			{
+				const auto* reduced = resampler.downsampleInput (input.data() + start, blocksize);
+
+				auto& harmony = resampler.getHarmonyBuffer (reducedSize);
+
+				for (auto chan = 0; chan < 2; ++chan)
+				{
+					harmony.copyFrom (chan, 0, reduced, reducedSize);
+					lead.copyFrom (chan, 0, reduced, reducedSize);
+				}
+
+				resampler.upsampleHarmony (output);
+
+				const auto& upsampledLead = resampler.upsampleLead (lead);
+
+				std::copy (output.getReadPointer (0), output.getReadPointer (0) + blocksize, harmonyOut.begin() + start);
+				std::copy (upsampledLead.getReadPointer (0), upsampledLead.getReadPointer (0) + blocksize, leadOut.begin() + start);
+			}
+
+			const auto reported = resampler.getLatencySamples();
+
+			expectEquals (measureDelay (input, harmonyOut, maxLag, settleSamples), reported, "harmony path");
+			expectEquals (measureDelay (input, leadOut, maxLag, settleSamples), reported, "lead path");
+		}
+	}
+
+private:
+
+	static constexpr auto blocksize		= 256;
+	static constexpr auto numSamples	= blocksize * 16;
+	static constexpr auto maxLag		= 256;
+	static constexpr auto settleSamples = 512;
+};
+
+static ResamplerLatencyTests resamplerLatencyTests;
+
+
+class LimiterLatencyTests : public juce::UnitTest
+{
+public:
+
+	LimiterLatencyTests()
+		: juce::UnitTest ("Output limiter latency", "Imogen")
+	{
+	}
+
+	void runTest() final
+	{
+		for (auto oversample : { false, true })
+		{
+			for (auto truePeak : { false, true })
+			{
+				for (auto isOn : { false, true })
+				{
+					beginTest (juce::String (oversample ? "Oversampled" : "Session rate") + ", true-peak "
+							   + (truePeak ? "on" : "off") + ", limiter " + (isOn ? "on" : "off"));
+
+					State state;
+					state.parameters.limiterToggle->set (isOn);
+					state.parameters.engineState.limiterTruePeak->set (truePeak);
+
+					Limiter<double> limiter { state };
+					limiter.configure (samplerate, oversample);
+					limiter.prepare (samplerate, blocksize);
+
+					// kept under the threshold, so the only difference between input and output is the delay
+					const auto input = makeTestSignal (numSamples);
+
+					std::vector<double> output (static_cast<size_t> (numSamples));
+
+					juce::AudioBuffer<double> block (2, blocksize);
+
+					for (auto start = 0; start < numSamples; start += blocksize)
+					{
+						for (auto chan = 0; chan < 2; ++chan)
+							block.copyFrom (chan, 0, input.data() + start, blocksize);
+
+						limiter.process (block);
+
+						std::copy (block.getReadPointer (0), block.getReadPointer (0) + blocksize, output.begin() + start);
+					}
+
+					expectEquals (measureDelay (input, output, maxLag, settleSamples), limiter.getLatencySamples());
+				}
+			}
+		}
+	}
+
+private:
+
+	static constexpr auto samplerate	= 48000.;
+	static constexpr auto blocksize		= 256;
+	static constexpr auto numSamples	= blocksize * 16;
+	static constexpr auto maxLag		= 256;
+	static constexpr auto settleSamples = 512;
+};
+
+static LimiterLatencyTests limiterLatencyTests;
+
+}  // namespace Imogen
@@ -2,16 +2,34 @@
 #include "imogen_dsp.h"
 
 
+#include "Engine/BufferArena.cpp"
+
+#include "Engine/Resampling/HalfbandFilter.cpp"
+#include "Engine/Resampling/Oversampler.cpp"
+#include "Engine/Resampling/HarmonyResampler.cpp"
+
+#include "Engine/effects/Dynamics/EnvelopeFollower.cpp"
+#include "Engine/effects/Dynamics/GainComputer.cpp"
+#include "Engine/effects/Dynamics/DynamicsProcessor.cpp"
+#include "Engine/effects/Dynamics/SlidingMaximum.cpp"
+#include "Engine/effects/Dynamics/LookaheadLimiter.cpp"
+
 #include "Engine/effects/PreHarmony/StereoReducer.cpp"
+#include "Engine/effects/PreHarmony/LoCutFilter.cpp"
 #include "Engine/effects/PreHarmony/InputGain.cpp"
 #include "Engine/effects/PreHarmony/NoiseGate.cpp"
 #include "Engine/effects/PreHarmonyEffects.cpp"
 
+#include "Engine/Analysis/VoicingDetector.cpp"
+#include "Engine/Analysis/UnvoicedCrossfade.cpp"
+
 #include "Engine/Harmonizer/Harmonizer.cpp"
+#include "Engine/Harmonizer/MicroDetune.cpp"
 #include "Engine/Harmonizer/HarmonizerVoice.cpp"
 
 #include "Engine/Lead/LeadProcessor.cpp"
 #include "Engine/Lead/DryPanner.cpp"
+#include "Engine/Lead/DryMonitor.cpp"
 #include "Engine/Lead/PitchCorrector.cpp"
 
 #include "Engine/effects/PostHarmony/EQ.cpp"
@@ -23,8 +41,19 @@
 #include "Engine/effects/PostHarmony/OutputGain.cpp"
 #include "Engine/effects/PostHarmony/Limiter.cpp"
 
+#include "Engine/effects/EffectsPipeline.cpp"
 #include "Engine/effects/PostHarmonyEffects.cpp"
 
+#include "Engine/LoadGovernor.cpp"
+#include "Engine/DeferredInitializer.cpp"
+#include "Engine/WorkerPool.cpp"
 #include "Engine/Engine.cpp"
 
 #include "Processor/Processor.cpp"
+
+#if JUCE_UNIT_TESTS
+#include "Tests/LatencyTests.cpp"
+#include "Tests/DynamicsMathTests.cpp"
+#include "Tests/AnalysisWindowTests.cpp"
+#include "Tests/HarmonizerStressTests.cpp"
+#endif
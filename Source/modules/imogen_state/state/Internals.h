@@ -7,6 +7,25 @@ struct Internals
 {
 	void addToList (plugin::ParameterList& list);
 
+	// whatever in the engine talks to MTS-ESP. It's only ever queried from the message thread
+	struct TuningSource
+	{
+		virtual ~TuningSource() = default;
+
+		virtual bool		 isMtsEspConnected()  = 0;
+		virtual juce::String getMtsEspScaleName() = 0;
+	};
+
+	// replaces the current source. Neither of these may be called from the audio thread
+	void setTuningSource (TuningSource* source);
+
+	// does nothing if source isn't the current one
+	void removeTuningSource (TuningSource* source);
+
+	// MTS-ESP masters don't notify their clients of changes, so the processor calls this a few times a second from a
+	// message thread timer. Fetching the scale name allocates, which is why this isn't done on the audio thread
+	void pollTuning();
+
 	ToggleParam abletonLinkEnabled { "Ableton link toggle", false };
 
 	IntParam abletonLinkSessionPeers { 0, 50, 0, "Ableton link num session peers",
@@ -15,7 +34,23 @@ struct Internals
 
 	ToggleParam mtsEspIsConnected { "MTS-ESP is connected", false };
 
-	//    plugin::StringProperty mtsEspScaleName {"Scale name"};
+	// a string can't be a parameter, so the active MTS-ESP scale's name is kept here. pollTuning() writes it when the
+	// scale changes, and the GUI reads it, so the audio thread never touches it
+	class ScaleName
+	{
+	public:
+
+		void set (const juce::String& newName);
+
+		juce::String get() const;
+
+	private:
+
+		juce::SpinLock lock;
+		juce::String   name { TRANS ("Not connected") };
+	};
+
+	ScaleName mtsEspScaleName;
 
 	IntParam lastMovedMidiController { 0, 127, 0, "Last moved MIDI controller number" };
 
@@ -23,6 +58,46 @@ struct Internals
 
 	BoolParam guiDarkMode { true, "GUI Dark mode" };
 
+	// only counts the engine's own objects and buffers, not what the synth, psola and effects libraries allocate inside
+	// theirs, so it's a lower bound. Always recomputed from the figures below, so a restored value is overwritten
+	IntParam engineMemoryKb { 0, 1 << 20, 0, "Engine memory, lower bound (kB)" };
+
+	// each engine's own share of the total above
+	std::atomic<int> floatEngineMemoryKb { 0 }, doubleEngineMemoryKb { 0 };
+
+	// set by the host at runtime, so it's kept out of the saved state
+	std::atomic<bool> isNonRealtime { false };
+
+	// the length of the host's most recent block, which can be shorter than the engine's chunks
+	std::atomic<int> hostBlocksize { 0 };
+
+	// true while the processor is adding the lead to the output itself, so the engine leaves its own copy out. It
+	// follows the host's transport, so it's kept out of the saved state
+	std::atomic<bool> isMonitoringDry { false };
+
+	// the engine's whole delay: the chunk, what the resampler and limiter add inside each chunk, and the pipelined
+	// effects' extra chunk. The engine only reports its chunk size itself, so the processor reports this instead
+	std::atomic<int> latencySamples { 0 };
+
+	// where the sidechain bus's channel sits in the engine's input, or -1 if the bus is disabled. It follows the
+	// host's bus layout, so like isNonRealtime it's kept out of the saved state
+	std::atomic<int> sidechainChannel { -1 };
+
+	// how far the harmonies trail the input. The lead trails it by the same amount, unless it's being dry monitored.
+	// Most of it is the analysis window, which the voice range sets
+	IntParam harmonyLatencyMs { 0, 10000, 0, "Harmony latency (ms)" };
+
+	IntParam cpuQualityTier { 0, 2, 0, "CPU quality tier",
+							  [] (int tier, int maxLength)
+							  {
+								  switch (tier)
+								  {
+									  case (1) : return TRANS ("Reduced").substring (0, maxLength);
+									  case (2) : return TRANS ("Minimal").substring (0, maxLength);
+									  default : return TRANS ("Full").substring (0, maxLength);
+								  }
+							  } };
+
 	IntParam currentInputNote { -1, 127, -1, "Current input note",
 								[] (int note, int maxLength)
 								{
@@ -42,26 +117,23 @@ struct Internals
 								 nullptr,
 								 TRANS ("cents") };
 
+	IntParam voicingConfidence { 0, 100, 100, "Voicing confidence",
+								 [] (int percent, int maxLength)
+								 { return (juce::String (percent) + "%").substring (0, maxLength); } };
+
 private:
 
+	juce::CriticalSection tuningSourceLock;
+	TuningSource*		  tuningSource { nullptr };
+
+	// the connection status restored with a session may be stale, so the first poll always writes it
+	bool hasPolledTuning { false };
+
 	plugin::ParamUpdater linkPeersUpdater { abletonLinkEnabled, [&]
 											{
 												if (! abletonLinkEnabled->get())
 													abletonLinkSessionPeers->set (0);
 											} };
-
-	//    plugin::ParamUpdater scaleNameUpdater {mtsEspIsConnected, [&]
-	//                                           {
-	//                                               if (mtsEspIsConnected->get())
-	//                                               {
-	//                                                   mtsEspScaleName->setDefault ("UnnamedScale");
-	//                                               }
-	//                                               else
-	//                                               {
-	//                                                   mtsEspScaleName->setDefault ("Not connected");
-	//                                                   mtsEspScaleName->set ("Not connected");
-	//                                               }
-	//                                           }};
 };
 
 }  // namespace Imogen
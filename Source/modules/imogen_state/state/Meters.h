@@ -21,6 +21,10 @@ struct Meters
 	GainMeter reverbLevel { "Reverb level", otherMeter };
 	GainMeter delayLevel { "Delay level", otherMeter };
 
+	// the dynamics stages report the gain they applied, in dB: 0 for none, and negative as they reduce it. That's what
+	// the reduction meters show, with the same -60 dB floor the level meters use
+	static float toReduction (double gainDb) noexcept { return juce::jlimit (-60.f, 0.f, static_cast<float> (gainDb)); }
+
 private:
 
 	static constexpr auto inputMeter   = juce::AudioProcessorParameter::inputMeter;
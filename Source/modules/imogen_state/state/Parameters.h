@@ -4,6 +4,7 @@
 #include "sublists/EQState.h"
 #include "sublists/ReverbState.h"
 #include "sublists/MidiState.h"
+#include "sublists/EngineState.h"
 
 namespace Imogen
 {
@@ -59,11 +60,16 @@ struct Parameters : plugin::ParameterList
 
 	ToggleParam limiterToggle { "Limiter toggle", true };
 
+	// analyzes and shifts the sidechain input instead of the main input
+	ToggleParam sidechainAnalysis { "Sidechain analysis", false };
+
 	EQState eqState { *this };
 
 	ReverbState reverbState { *this };
 
 	MidiState midiState { *this };
+
+	EngineState engineState { *this };
 };
 
 
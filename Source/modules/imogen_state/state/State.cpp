@@ -14,7 +14,7 @@ State::State() : plugin::CustomState<Parameters, CustomStateData> ("Imogen")
 Parameters::Parameters()
 	: ParameterList ("ImogenParameters")
 {
-	add (inputMode, dryWet, inputGain, outputGain, leadBypass, harmonyBypass, stereoWidth, lowestPanned, leadPan, noiseGateToggle, noiseGateThresh, deEsserToggle, deEsserThresh, deEsserAmount, compToggle, compAmount, delayToggle, delayDryWet, limiterToggle);
+	add (inputMode, dryWet, inputGain, outputGain, leadBypass, harmonyBypass, stereoWidth, lowestPanned, leadPan, noiseGateToggle, noiseGateThresh, deEsserToggle, deEsserThresh, deEsserAmount, compToggle, compAmount, delayToggle, delayDryWet, limiterToggle, sidechainAnalysis);
 }
 
 
@@ -25,8 +25,50 @@ void Meters::addToList (plugin::ParameterList& list)
 
 void Internals::addToList (plugin::ParameterList& list)
 {
-	list.addInternal (abletonLinkEnabled, abletonLinkSessionPeers, mtsEspIsConnected, lastMovedMidiController, lastMovedCCValue, guiDarkMode, currentInputNote, currentCentsSharp);
-	// mtsEspScaleName
+	list.addInternal (abletonLinkEnabled, abletonLinkSessionPeers, mtsEspIsConnected, lastMovedMidiController, lastMovedCCValue, guiDarkMode, engineMemoryKb, cpuQualityTier, currentInputNote, currentCentsSharp, voicingConfidence, harmonyLatencyMs);
+}
+
+void Internals::setTuningSource (TuningSource* source)
+{
+	const juce::ScopedLock sl (tuningSourceLock);
+	tuningSource = source;
+}
+
+void Internals::removeTuningSource (TuningSource* source)
+{
+	const juce::ScopedLock sl (tuningSourceLock);
+
+	if (tuningSource == source)
+		tuningSource = nullptr;
+}
+
+void Internals::pollTuning()
+{
+	const juce::ScopedLock sl (tuningSourceLock);
+
+	const auto isConnected = tuningSource != nullptr && tuningSource->isMtsEspConnected();
+
+	if (! hasPolledTuning || mtsEspIsConnected->get() != isConnected)
+		mtsEspIsConnected->set (isConnected);
+
+	hasPolledTuning = true;
+
+	const auto scaleName = isConnected ? tuningSource->getMtsEspScaleName() : TRANS ("Not connected");
+
+	if (scaleName != mtsEspScaleName.get())
+		mtsEspScaleName.set (scaleName);
+}
+
+void Internals::ScaleName::set (const juce::String& newName)
+{
+	const juce::SpinLock::ScopedLockType sl (lock);
+	name = newName;
+}
+
+juce::String Internals::ScaleName::get() const
+{
+	const juce::SpinLock::ScopedLockType sl (lock);
+	return name;
 }
 
 
@@ -49,4 +91,15 @@ MidiState::MidiState (plugin::ParameterList& list)
 	list.setPitchbendParameter (editorPitchbend);
 }
 
+
+EngineState::EngineState (plugin::ParameterList& list)
+{
+	list.addInternal (pipelinedEffects, internalResampling, limiterTruePeak, unvoicedPassthrough, unisonDetune, numSingers, dryMonitoring, voiceRange);
+}
+
+int EngineState::getLowestPitchHz (int range)
+{
+	return voiceRangeFloorsHz[juce::jlimit (0, static_cast<int> (std::size (voiceRangeFloorsHz)) - 1, range)];
+}
+
 }  // namespace Imogen
@@ -0,0 +1,60 @@
+#pragma once
+
+namespace Imogen
+{
+struct EngineState
+{
+	EngineState (plugin::ParameterList& list);
+
+	// takes effect on the next prepare
+	ToggleParam pipelinedEffects { "Pipelined effects", false };
+
+	// in high-rate sessions, runs the analyzer, harmonizer and lead at 44.1 or 48 kHz
+	ToggleParam internalResampling { "Resample harmony path", false };
+
+	// measures the output limiter's peaks on a 4x upsampled copy of the signal
+	ToggleParam limiterTruePeak { "True-peak limiting", false };
+
+	// while the input is unvoiced, the voices and the lead pass it through instead of resynthesizing it
+	ToggleParam unvoicedPassthrough { "Unvoiced passthrough", true };
+
+	// drifts each harmony voice a few cents around its pitch, so that doubled voices don't phase-lock
+	ToggleParam unisonDetune { "Unison micro-detune", false };
+
+	// each input channel becomes a separate singer, with its own analysis and harmony voices
+	IntParam numSingers { 1, 4, 1, "Singers" };
+
+	// while the transport is stopped, the lead goes straight from the input to the output, unprocessed, and only the
+	// harmonies are delayed. Takes effect on the next prepare
+	ToggleParam dryMonitoring { "Zero-latency dry monitoring", false };
+
+	// the analysis window has to cover the lowest pitch it tracks, and the whole engine waits on it. A higher range
+	// means less latency and less analysis work, but notes below its floor aren't tracked. Takes effect on the next prepare
+	IntParam voiceRange { 0, 4, 1, "Voice range",
+						  [] (int range, int maxLength)
+						  {
+							  switch (range)
+							  {
+								  case (0) : return TRANS ("Bass").substring (0, maxLength);
+								  case (2) : return TRANS ("Tenor").substring (0, maxLength);
+								  case (3) : return TRANS ("Alto").substring (0, maxLength);
+								  case (4) : return TRANS ("Soprano").substring (0, maxLength);
+								  default : return TRANS ("Baritone").substring (0, maxLength);
+							  }
+						  },
+						  [] (const juce::String& text)
+						  {
+							  if (text.containsIgnoreCase (TRANS ("Bass"))) return 0;
+							  if (text.containsIgnoreCase (TRANS ("Tenor"))) return 2;
+							  if (text.containsIgnoreCase (TRANS ("Alto"))) return 3;
+							  if (text.containsIgnoreCase (TRANS ("Soprano"))) return 4;
+							  return 1;
+						  } };
+
+	// the lowest pitch the analyzer tracks in each voice range. Baritone is the analyzer's own default
+	static constexpr int voiceRangeFloorsHz[] = { 50, 60, 90, 130, 200 };
+
+	static int getLowestPitchHz (int range);
+};
+
+}  // namespace Imogen